@@ -0,0 +1,219 @@
+// bench.c
+// Microbenchmark harness for the allocator and linked list hot paths.
+// Built and run through `make bench`. Emits one CSV row per configuration
+// on stdout for regression tracking:
+//
+//   benchmark,threads,param,ops,seconds,ops_per_sec,p50_ns,p99_ns
+//
+// Every operation is timed individually with clock_gettime so the p50/p99
+// latencies come from real samples, not a derived average.
+#include "linked_list.h"
+#include "common_defs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ALLOC_ITERATIONS 100000     // Alloc/free pairs per thread
+#define SEARCH_OPERATIONS 2000      // Searches per list-length configuration
+
+typedef struct
+{
+    size_t block_size;
+    long iterations;
+    my_barrier_t *barrier;
+    long long *samples;     // One latency sample per operation, in nanoseconds
+} bench_thread_args;
+
+
+static long long now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+
+static int compare_samples(const void *a, const void *b)
+{
+    long long lhs = *(const long long *)a;
+    long long rhs = *(const long long *)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+
+// Sorts the samples and prints one CSV row for the finished configuration
+static void report(const char *benchmark, int threads, long param, long ops,
+                   long long wall_ns, long long *samples, long sample_count)
+{
+    qsort(samples, sample_count, sizeof(samples[0]), compare_samples);
+    long long p50 = samples[sample_count / 2];
+    long long p99 = samples[(long)(sample_count * 0.99)];
+    double seconds = (double)wall_ns / 1e9;
+    printf("%s,%d,%ld,%ld,%.6f,%.0f,%lld,%lld\n",
+           benchmark, threads, param, ops, seconds, (double)ops / seconds, p50, p99);
+    fflush(stdout);
+}
+
+
+static void *alloc_free_worker(void *arg)
+{
+    bench_thread_args *args = (bench_thread_args *)arg;
+    my_barrier_wait(args->barrier);
+    for (long i = 0; i < args->iterations; i++)
+    {
+        long long start = now_ns();
+        void *block = mem_alloc(args->block_size);
+        mem_free(block);
+        args->samples[i] = now_ns() - start;
+    }
+    return NULL;
+}
+
+
+// mem_alloc/mem_free pairs of one size across a thread count
+static void bench_alloc_free(int num_threads, size_t block_size)
+{
+    mem_init(16 * 1024 * 1024);
+
+    pthread_t threads[num_threads];
+    bench_thread_args args[num_threads];
+    my_barrier_t barrier;
+    my_barrier_init(&barrier, num_threads + 1);     // +1 so main releases all workers at once
+
+    for (int i = 0; i < num_threads; i++)
+    {
+        args[i].block_size = block_size;
+        args[i].iterations = ALLOC_ITERATIONS;
+        args[i].barrier = &barrier;
+        args[i].samples = malloc(ALLOC_ITERATIONS * sizeof(long long));
+        pthread_create(&threads[i], NULL, alloc_free_worker, &args[i]);
+    }
+
+    my_barrier_wait(&barrier);
+    long long start = now_ns();
+    for (int i = 0; i < num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    long long wall_ns = now_ns() - start;
+
+    // Merge the per-thread samples for one combined distribution
+    long total = (long)num_threads * ALLOC_ITERATIONS;
+    long long *samples = malloc(total * sizeof(long long));
+    for (int i = 0; i < num_threads; i++)
+    {
+        memcpy(&samples[(long)i * ALLOC_ITERATIONS], args[i].samples, ALLOC_ITERATIONS * sizeof(long long));
+        free(args[i].samples);
+    }
+    report("mem_alloc_free", num_threads, (long)block_size, total, wall_ns, samples, total);
+    free(samples);
+
+    my_barrier_destroy(&barrier);
+    mem_deinit();
+}
+
+
+// Appends to a bare-head list; cost grows with the list, so the length
+// parameter is the interesting axis
+static void bench_list_insert(long length)
+{
+    Node *head = NULL;
+    list_init(&head, (size_t)length * 2);   // list_init sizes the pool in nodes
+
+    long long *samples = malloc(length * sizeof(long long));
+    long long start = now_ns();
+    for (long i = 0; i < length; i++)
+    {
+        long long op_start = now_ns();
+        list_insert(&head, (uint16_t)i);
+        samples[i] = now_ns() - op_start;
+    }
+    long long wall_ns = now_ns() - start;
+
+    report("list_insert", 1, length, length, wall_ns, samples, length);
+    free(samples);
+    list_cleanup(&head);
+    mem_deinit();
+}
+
+
+static void bench_list_search(long length)
+{
+    Node *head = NULL;
+    list_init(&head, (size_t)length * 2);   // list_init sizes the pool in nodes
+    for (long i = 0; i < length; i++)
+    {
+        list_insert(&head, (uint16_t)i);
+    }
+
+    long long *samples = malloc(SEARCH_OPERATIONS * sizeof(long long));
+    long long start = now_ns();
+    for (long i = 0; i < SEARCH_OPERATIONS; i++)
+    {
+        uint16_t needle = (uint16_t)(rand() % length);
+        long long op_start = now_ns();
+        list_search(&head, needle);
+        samples[i] = now_ns() - op_start;
+    }
+    long long wall_ns = now_ns() - start;
+
+    report("list_search", 1, length, SEARCH_OPERATIONS, wall_ns, samples, SEARCH_OPERATIONS);
+    free(samples);
+    list_cleanup(&head);
+    mem_deinit();
+}
+
+
+static void bench_list_delete(long length)
+{
+    Node *head = NULL;
+    list_init(&head, (size_t)length * 2);   // list_init sizes the pool in nodes
+    for (long i = 0; i < length; i++)
+    {
+        list_insert(&head, (uint16_t)i);
+    }
+
+    long long *samples = malloc(length * sizeof(long long));
+    long long start = now_ns();
+    for (long i = 0; i < length; i++)
+    {
+        long long op_start = now_ns();
+        list_delete(&head, (uint16_t)i);    // Always deletes the current head: steady-state cost
+        samples[i] = now_ns() - op_start;
+    }
+    long long wall_ns = now_ns() - start;
+
+    report("list_delete", 1, length, length, wall_ns, samples, length);
+    free(samples);
+    list_cleanup(&head);
+    mem_deinit();
+}
+
+
+int main(void)
+{
+    srand(42);      // Fixed seed so runs are comparable
+
+    printf("benchmark,threads,param,ops,seconds,ops_per_sec,p50_ns,p99_ns\n");
+
+    size_t block_sizes[] = { 16, 128, 1024, 4096 };
+    int thread_counts[] = { 1, 2, 4, 8 };
+    for (size_t s = 0; s < sizeof(block_sizes) / sizeof(block_sizes[0]); s++)
+    {
+        for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++)
+        {
+            bench_alloc_free(thread_counts[t], block_sizes[s]);
+        }
+    }
+
+    long list_lengths[] = { 1000, 10000 };
+    for (size_t l = 0; l < sizeof(list_lengths) / sizeof(list_lengths[0]); l++)
+    {
+        bench_list_insert(list_lengths[l]);
+        bench_list_search(list_lengths[l]);
+        bench_list_delete(list_lengths[l]);
+    }
+
+    return 0;
+}
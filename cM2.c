@@ -4,6 +4,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sys/syscall.h>
+
+#include "trace_format.h"
+#include "memory_manager.h"
 
 char tmpbuff[1024];
 unsigned long tmppos = 0;
@@ -12,6 +21,206 @@ unsigned long tmpallocs = 0;
 void *memset(void*,int,size_t);
 void *memmove(void *to, const void *from, size_t size);
 
+/*=========================================================
+ * binary trace recording
+ *
+ * Every hook appends one fixed-size event to a per-thread ring buffer;
+ * the buffer is written out in one batch when it fills and when the
+ * thread (or process) exits. No formatting happens on the hot path and
+ * the only synchronization is around the batched file append, so tracing
+ * costs a few percent instead of the 50x of per-call printf logging.
+ * Decode the file with trace_decode. Set MTRACE_FILE to choose the
+ * output path (default mtrace.bin).
+ */
+
+#define RING_EVENTS 1024
+#define MAX_TRACE_RINGS 256     /* concurrently tracing threads; rings are reused */
+
+typedef struct {
+  trace_event_t events[RING_EVENTS];
+  unsigned long count;
+  int active;                   /* 1 while owned by a live thread */
+} trace_ring_t;
+
+/* The per-thread state must stay a small initial-exec TLS pointer: a large
+ * __thread buffer in a preloaded library is allocated lazily through
+ * __tls_get_addr, which calls malloc and recurses straight back into the
+ * hook. The rings themselves live in this static pool instead. */
+static trace_ring_t ring_pool[MAX_TRACE_RINGS];
+static __thread trace_ring_t *my_ring __attribute__((tls_model("initial-exec"))) = NULL;
+static __thread uint32_t cached_tid __attribute__((tls_model("initial-exec"))) = 0;
+
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static int trace_fd = -1;
+static int trace_disabled = 0;
+static pthread_key_t ring_key;
+static pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
+
+static uint64_t trace_now(void){
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static uint32_t trace_tid(void){
+  if (cached_tid == 0)
+    cached_tid = (uint32_t)syscall(SYS_gettid);
+  return cached_tid;
+}
+
+/* Opens the trace file and writes its header; called once, under trace_lock */
+static void trace_open(void){
+  const char *path = getenv("MTRACE_FILE");
+  if (path == NULL)
+    path = "mtrace.bin";
+  trace_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+  if (trace_fd < 0){
+    trace_disabled = 1;
+    return;
+  }
+  trace_file_header_t header;
+  header.magic = TRACE_MAGIC;
+  header.version = TRACE_VERSION;
+  header.event_size = sizeof(trace_event_t);
+  header.reserved = 0;
+  if (write(trace_fd, &header, sizeof(header)) != (ssize_t)sizeof(header))
+    trace_disabled = 1;
+}
+
+/* Appends the calling thread's buffered events to the file in one write */
+static void ring_flush(trace_ring_t *r){
+  if (r->count == 0)
+    return;
+  pthread_mutex_lock(&trace_lock);
+  if (trace_fd < 0 && !trace_disabled)
+    trace_open();
+  if (!trace_disabled)
+    write(trace_fd, r->events, r->count * sizeof(trace_event_t));
+  pthread_mutex_unlock(&trace_lock);
+  r->count = 0;
+}
+
+static void ring_destructor(void *arg){
+  trace_ring_t *r = (trace_ring_t *)arg;
+  ring_flush(r);
+  r->active = 0;                /* ring becomes claimable by a new thread */
+}
+
+static void create_ring_key(void){
+  pthread_key_create(&ring_key, ring_destructor);
+}
+
+__attribute__((destructor))
+static void trace_shutdown(void){
+  if (my_ring != NULL)
+    ring_flush(my_ring);        /* the main thread never runs its destructor */
+}
+
+/* Claims an idle ring from the pool for the calling thread, or disables
+ * tracing for it when all rings are taken */
+static trace_ring_t *ring_claim(void){
+  pthread_once(&ring_key_once, create_ring_key);
+  pthread_mutex_lock(&trace_lock);
+  for (int i = 0; i < MAX_TRACE_RINGS; i++){
+    if (!ring_pool[i].active){
+      ring_pool[i].active = 1;
+      ring_pool[i].count = 0;
+      my_ring = &ring_pool[i];
+      break;
+    }
+  }
+  pthread_mutex_unlock(&trace_lock);
+  if (my_ring != NULL)
+    pthread_setspecific(ring_key, my_ring);
+  return my_ring;
+}
+
+static void record(uint8_t op, const void *ptr, size_t size){
+  if (trace_disabled)
+    return;
+  trace_ring_t *r = my_ring;
+  if (r == NULL){
+    r = ring_claim();
+    if (r == NULL)
+      return;
+  }
+  trace_event_t *event = &r->events[r->count++];
+  event->timestamp = trace_now();
+  event->ptr = (uint64_t)(uintptr_t)ptr;
+  event->size = (uint64_t)size;
+  event->tid = trace_tid();
+  event->op = op;
+  event->pad[0] = event->pad[1] = event->pad[2] = 0;
+  if (r->count == RING_EVENTS)
+    ring_flush(r);
+}
+
+/*=========================================================
+ * pool routing
+ *
+ * With MROUTE_THRESHOLD set, allocations smaller than the threshold are
+ * served from the pool allocator instead of libc, giving LD_PRELOAD-level
+ * adoption of the pool for binaries that cannot be recompiled. The pool is
+ * created on library load with MROUTE_POOL_SIZE bytes (default 64 MiB).
+ * Larger requests, and any request the pool cannot satisfy, pass through
+ * to libc; frees ask the pool whether it owns the pointer, so the two
+ * allocators mix freely in one process. The pool's own internal
+ * allocations (chunks, header slabs, map tables) are kept out of the pool
+ * by a per-thread reentry guard, which also prevents re-entering a shard
+ * lock the current thread already holds. The pool is never torn down:
+ * destructors of other libraries may still free pool pointers on exit.
+ */
+
+static size_t route_threshold = 0;      /* 0: routing disabled */
+static __thread int route_busy __attribute__((tls_model("initial-exec"))) = 0;
+
+__attribute__((constructor))
+static void route_init(void){
+  const char *threshold = getenv("MROUTE_THRESHOLD");
+  if (threshold == NULL)
+    return;
+  size_t value = (size_t)strtoul(threshold, NULL, 10);
+  if (value == 0)
+    return;
+  const char *pool = getenv("MROUTE_POOL_SIZE");
+  size_t pool_size = pool ? (size_t)strtoul(pool, NULL, 10)
+                          : (size_t)64 * 1024 * 1024;
+  route_busy = 1;               /* pool-internal mallocs pass through to libc */
+  mem_init(pool_size);
+  route_busy = 0;
+  route_threshold = value;      /* publish only once the pool is live */
+}
+
+/* Serves a small request from the pool, or NULL to fall through to libc */
+static void *route_alloc(size_t size){
+  if (route_threshold == 0 || route_busy || size == 0 || size >= route_threshold)
+    return NULL;
+  route_busy = 1;
+  void *ptr = mem_alloc_aligned(size, 16);  /* libc guarantees 16-byte alignment */
+  route_busy = 0;
+  return ptr;
+}
+
+/* Returns the pool block behind ptr, or NULL when libc owns it */
+static mem_handle route_owner(void *ptr){
+  if (route_threshold == 0 || route_busy || ptr == NULL)
+    return NULL;
+  route_busy = 1;
+  mem_handle handle = mem_handle_of(ptr);
+  route_busy = 0;
+  return handle;
+}
+
+static void route_free(void *ptr){
+  route_busy = 1;
+  mem_free(ptr);
+  route_busy = 0;
+}
+
 /*=========================================================
  * interception points
  */
@@ -33,8 +242,8 @@ static void init(){
   myfn_memalign   = dlsym(RTLD_NEXT, "memalign");
   myfn_mmap       = dlsym(RTLD_NEXT, "mmap");
   myfn_munmap     = dlsym(RTLD_NEXT, "munmap");
-  
-  if (!myfn_malloc || !myfn_free || !myfn_calloc || !myfn_realloc || !myfn_memalign || !myfn_mmap || !myfn_munmap ) 
+
+  if (!myfn_malloc || !myfn_free || !myfn_calloc || !myfn_realloc || !myfn_memalign || !myfn_mmap || !myfn_munmap )
     {
       fprintf(stderr, "Error in `dlsym`: %s\n", dlerror());
       exit(1);
@@ -49,8 +258,6 @@ void *malloc(size_t size){
       initializing = 1;
       init();
       initializing = 0;
-      fprintf(stdout, "rMALLOC(%lu)\n", size);      
-      fprintf(stdout, "jcheck: allocated %lu bytes of temp memory in %lu chunks during initialization\n", tmppos, tmpallocs);
     }
     else {
       if (tmppos + size < sizeof(tmpbuff)) {
@@ -60,39 +267,36 @@ void *malloc(size_t size){
 	return retptr;
       }
       else {
-	fprintf(stdout, "jcheck: too much memory requested during initialisation - increase tmpbuff size\n");
+	fprintf(stderr, "jcheck: too much memory requested during initialisation - increase tmpbuff size\n");
 	exit(1);
       }
     }
   }
 
-  void *ptr = myfn_malloc(size);
-  char buffer[50];
-  int len=sprintf(buffer,"rMALLOc (%ld) at %p\n",size,ptr);
-  write(1,buffer,len);
+  void *ptr = route_alloc(size);
+  if (ptr == NULL)
+    ptr = myfn_malloc(size);
+  record(TRACE_OP_MALLOC, ptr, size);
   return ptr;
 }
 
 void free(void *ptr){
-  // something wrong if we call free before one of the allocators!
-  //  if (myfn_malloc == NULL)
-  //      init();
-  
   if (ptr >= (void*) tmpbuff && ptr <= (void*)(tmpbuff + tmppos))
-    fprintf(stdout, "freeing temp memory\n");
+    return;                     /* temp bootstrap memory is never released */
+
+  /* The dynamic linker can hand us a free before any allocator ran */
+  if (myfn_free == NULL)
+    init();
+
+  if (route_owner(ptr) != NULL)
+    route_free(ptr);
   else
     myfn_free(ptr);
-
-  char buffer[50];
-  int len=sprintf(buffer,"rFREE at %p\n",ptr);
-  write(1,buffer,len);
+  record(TRACE_OP_FREE, ptr, 0);
 }
 
 void *realloc(void *ptr, size_t size)
 {
-  char buffer[70];
-  int len=sprintf(buffer,"rREALLOC-> (%ld) at %p \n",size,ptr);
-  write(1,buffer,len);
     if (myfn_malloc == NULL)
     {
         void *nptr = malloc(size);
@@ -104,11 +308,38 @@ void *realloc(void *ptr, size_t size)
         return nptr;
     }
 
-    void *nptr = myfn_realloc(ptr, size);
-
-
-    len=sprintf(buffer,"rREALLOC (%ld) at %p -> %p\n",size,ptr,nptr);
-    write(1,buffer,len);
+    record(TRACE_OP_REALLOC_IN, ptr, size);
+    mem_handle owner = route_owner(ptr);
+    void *nptr;
+    if (owner != NULL)
+    {
+        /* The pool owns the old block: place the new one by size as usual,
+         * copy the smaller of the two extents over and release the old one */
+        nptr = route_alloc(size);
+        if (nptr == NULL && size > 0)
+            nptr = myfn_malloc(size);
+        if (nptr != NULL)
+        {
+            size_t old_size = owner->size_of_block;
+            memmove(nptr, ptr, old_size < size ? old_size : size);
+        }
+        if (nptr != NULL || size == 0)
+            route_free(ptr);
+    }
+    else
+    {
+        nptr = route_alloc(size);
+        if (nptr != NULL && ptr != NULL)
+        {
+            /* Growing into the pool: libc owns the old block and knows its
+             * size; stay with libc rather than risk copying too little */
+            route_free(nptr);
+            nptr = NULL;
+        }
+        if (nptr == NULL)
+            nptr = myfn_realloc(ptr, size);
+    }
+    record(TRACE_OP_REALLOC_OUT, nptr, size);
     return nptr;
 }
 
@@ -118,27 +349,46 @@ void *calloc(size_t nmemb, size_t size)
     {
         void *ptr = malloc(nmemb*size);
         if (ptr)
-            memset(ptr, 0, nmemb*size);
+        {
+            /* Zero through a volatile pointer: gcc otherwise recognizes
+             * malloc-plus-clear and rewrites it into a call to calloc,
+             * which recurses straight back into this hook */
+            volatile char *zero = ptr;
+            for (size_t i = 0; i < nmemb*size; i++)
+                zero[i] = 0;
+        }
         return ptr;
     }
 
-    void *ptr = myfn_calloc(nmemb, size);
-
-    char buffer[70];
-    int len=sprintf(buffer,"rCALLOC (%ld,%ld) \n",nmemb, size);
-    write(1,buffer,len);
-    
+    void *ptr = NULL;
+    if (size == 0 || nmemb <= SIZE_MAX / size)  /* let libc reject overflows */
+    {
+        ptr = route_alloc(nmemb * size);
+        if (ptr != NULL)
+            memset(ptr, 0, nmemb * size);
+    }
+    if (ptr == NULL)
+        ptr = myfn_calloc(nmemb, size);
+    record(TRACE_OP_CALLOC, ptr, nmemb * size);
     return ptr;
 }
 
 void *memalign(size_t blocksize, size_t bytes)
 {
-    void *ptr = myfn_memalign(blocksize, bytes);
+    if (myfn_memalign == NULL)
+        init();
 
-    char buffer[70];
-    int len=sprintf(buffer,"rMEMALING (%ld, %ld) @ %p\n",blocksize, bytes,ptr);
-    write(1,buffer,len);
-    
+    void *ptr = NULL;
+    if (route_threshold != 0 && !route_busy && bytes != 0 && bytes < route_threshold)
+    {
+        route_busy = 1;
+        /* A non-power-of-two alignment comes back NULL and falls through */
+        ptr = mem_alloc_aligned(bytes, blocksize < 16 ? 16 : blocksize);
+        route_busy = 0;
+    }
+    if (ptr == NULL)
+        ptr = myfn_memalign(blocksize, bytes);
+    record(TRACE_OP_MEMALIGN, ptr, bytes);
     return ptr;
 }
 
@@ -150,8 +400,6 @@ void *mmap(void *ptr,  size_t length, int prot, int flags, int fd, off_t offset)
       initializing = 1;
       init();
       initializing = 0;
-      fprintf(stdout, "rMMAP(%lu)\n", length);      
-      fprintf(stdout, "jcheck: allocated %lu bytes of temp memory in %lu chunks during initialization\n", tmppos, tmpallocs);
     }
     else {
      if (tmppos + length < sizeof(tmpbuff)) {
@@ -161,30 +409,22 @@ void *mmap(void *ptr,  size_t length, int prot, int flags, int fd, off_t offset)
 	return retptr;
       }
       else {
-	fprintf(stdout, "jcheck: too much memory requested during initialisation - increase tmpbuff size\n");
+	fprintf(stderr, "jcheck: too much memory requested during initialisation - increase tmpbuff size\n");
 	exit(1);
       }
     }
   }
   void *ptr2 = myfn_mmap(ptr, length, prot, flags, fd, offset);
-    
-  char buffer[70];
-  int len=sprintf(buffer,"rMMAP (%ld) at %p\n", length, ptr2);
-  write(1,buffer,len);
-  
+  record(TRACE_OP_MMAP, ptr2, length);
   return ptr2;
 }
 
 
 int munmap(void *ptr, size_t length){
-  char buffer[70];
-  int len=sprintf(buffer,"rMUNMMAP-> (%p,%ld) => \n",ptr, length);
-  write(1,buffer,len);
-  
-  int resp=myfn_munmap(ptr, length);
-
-  len=sprintf(buffer,"rMUNMMAP (%p,%ld) => %d\n",ptr, length, resp);
-  write(1,buffer,len);
+  if (myfn_munmap == NULL)
+    init();
 
+  int resp=myfn_munmap(ptr, length);
+  record(TRACE_OP_MUNMAP, ptr, length);
   return resp;
 }
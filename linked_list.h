@@ -11,17 +11,144 @@ typedef struct Node
 {
     uint16_t data;     // Stores the data as an unsigned 16-bit integer
     struct Node *next; // Pointer to the next node in the list
-    pthread_mutex_t lock;
-
 } Node;
 
+// List handle carrying head, tail and a cached count, so appends and counting
+// do not traverse the list. The Node** functions below remain for callers
+// that manage a bare head pointer.
+typedef struct List
+{
+    Node *head;  // First node in the list
+    Node *tail;  // Last node in the list, for O(1) appends
+    int count;   // Cached number of nodes
+} List;
+
+// Unrolled list: each node carries a small array of values so traversal
+// touches one cache line per CHUNK_CAPACITY values instead of one per value.
+// 24 values + count + next pointer fit a node into a single 64-byte line.
+#define CHUNK_CAPACITY 24
+
+typedef struct ChunkNode
+{
+    uint16_t values[CHUNK_CAPACITY]; // Values stored in this chunk, in order
+    int count;                       // Number of values currently in the chunk
+    struct ChunkNode *next;          // Pointer to the next chunk
+} ChunkNode;
+
+typedef struct ChunkList
+{
+    ChunkNode *head; // First chunk in the list
+    ChunkNode *tail; // Last chunk in the list, for O(1) appends
+    int count;       // Total number of values across all chunks
+} ChunkList;
+
+// Sorted list: nodes are kept in ascending key order and each node carries
+// a tower of express pointers (a skip list), so keyed lookup and ordered
+// insert walk O(log n) links instead of scanning the whole list.
+#define SKIP_MAX_LEVEL 16
+
+typedef struct SortedNode
+{
+    uint16_t data;                  // Stores the key as an unsigned 16-bit integer
+    int level;                      // Number of forward links in this node's tower
+    struct SortedNode *forward[];   // forward[0] is the next node in key order
+} SortedNode;
+
+typedef struct SortedList
+{
+    SortedNode *head;   // Sentinel head node with a full-height tower
+    int level;          // Height of the tallest tower currently in the list
+    int count;          // Cached number of nodes
+    unsigned int seed;  // Per-list PRNG state for drawing tower heights
+} SortedList;
+
+// Sorted-list operations
+void sorted_list_init(SortedList *list, size_t size);
+void list_insert_sorted(SortedList *list, uint16_t data);
+SortedNode *list_search_sorted(SortedList *list, uint16_t data);
+void sorted_list_delete(SortedList *list, uint16_t data);
+int sorted_list_count(SortedList *list);
+void sorted_list_cleanup(SortedList *list);
+
+// Concurrent list: built from its own node type carrying a per-node
+// mutex, so traversals can take the locks hand-over-hand and threads
+// working on different parts of the list run in parallel instead of
+// serializing behind one list-wide lock. Safe for any mix of concurrent
+// inserts, deletes and searches on the same list. The lock lives only
+// here: the plain Node stays two words, so the single-threaded variants
+// keep their cache footprint.
+typedef struct CNode
+{
+    uint16_t data;          // Stores the data as an unsigned 16-bit integer
+    struct CNode *next;     // Pointer to the next node in the list
+    pthread_mutex_t lock;   // Guards this node's link during hand-over-hand traversal
+} CNode;
+
+typedef struct CList
+{
+    CNode *head; // Sentinel node; its lock guards the first link
+    int count;   // Number of nodes, maintained with atomic adds
+} CList;
+
+// Arena-backed list: nodes are bump-allocated from a mem_arena instead of
+// individually pool-allocated, so tearing the list down is one O(1) arena
+// reset instead of one mem_free per node. Suits phase-based workloads that
+// build a list per request and drop it whole.
+typedef struct ArenaList
+{
+    Node *head;         // First node in the list
+    Node *tail;         // Last node in the list, for O(1) appends
+    int count;          // Cached number of nodes
+    mem_arena *arena;   // Every node is carved from this arena
+} ArenaList;
+
+// Arena-list operations
+void list_init_in_arena(ArenaList *list, mem_arena *arena);
+void arena_list_insert(ArenaList *list, uint16_t data);
+void arena_list_delete(ArenaList *list, uint16_t data);
+Node *arena_list_search(ArenaList *list, uint16_t data);
+int arena_list_count(ArenaList *list);
+void arena_list_reset(ArenaList *list);
+
+// Concurrent-list operations
+void clist_init(CList *list, size_t size);
+void clist_insert(CList *list, uint16_t data);
+void clist_delete(CList *list, uint16_t data);
+CNode *clist_search(CList *list, uint16_t data);
+int clist_count(CList *list);
+void clist_cleanup(CList *list);
+
+// Unrolled-list operations
+void chunk_list_init(ChunkList *list, size_t size);
+void chunk_list_insert(ChunkList *list, uint16_t data);
+void chunk_list_delete(ChunkList *list, uint16_t data);
+uint16_t *chunk_list_search(ChunkList *list, uint16_t data);
+uint16_t *list_search_fast(ChunkList *list, uint16_t data);
+int chunk_list_count(ChunkList *list);
+void chunk_list_cleanup(ChunkList *list);
+
+// Handle-based operations
+void list_handle_init(List *list, size_t size);
+void list_handle_insert(List *list, uint16_t data);
+void list_handle_delete(List *list, uint16_t data);
+Node *list_handle_search(List *list, uint16_t data);
+int list_handle_count(List *list);
+void list_handle_cleanup(List *list);
+
 // Function declarations
 void list_init(Node **head, size_t size);
 void list_insert(Node **head, uint16_t data);
+void list_insert_bulk(Node **head, const uint16_t *data, size_t n);
 void list_insert_after(Node *prev_node, uint16_t data);
 void list_insert_before(Node **head, Node *next_node, uint16_t data);
 void list_delete(Node **head, uint16_t data);
+void list_delete_deferred(Node **head, uint16_t data);
 Node *list_search(Node **head, uint16_t data);
+void list_sort(Node **head);
+Node *list_merge(Node *a, Node *b);
+
+int list_serialize(Node **head, int fd);
+int list_deserialize(Node **head, int fd);
 
 void list_display(Node **head);
 void list_display_range(Node **head, Node *start_node, Node *end_node);
@@ -29,4 +156,13 @@ void list_display_range(Node **head, Node *start_node, Node *end_node);
 int list_count_nodes(Node **head);
 void list_cleanup(Node **head);
 
+// Parallel traversal: the list is split into one segment per thread and
+// the segments are walked concurrently. The list must not be mutated
+// while a parallel operation runs.
+typedef void (*list_apply_fn)(Node *node, void *context);
+
+int list_count_parallel(Node **head, int nthreads);
+Node *list_search_parallel(Node **head, uint16_t data, int nthreads);
+void list_apply_parallel(Node **head, list_apply_fn fn, void *context, int nthreads);
+
 #endif // LINKED_LIST_H
@@ -1,203 +1,2308 @@
 #include "memory_manager.h"
 
+#ifdef LOCKFREE
+#include <stdatomic.h>
+#include <stdint.h>
+#endif
 
-static char *memory_pool = NULL;    
-static char *header_pool = NULL;      
-static Block *free_list = NULL;      
-static pthread_mutex_t memory_lock = PTHREAD_MUTEX_INITIALIZER;
+#ifdef DEBUG_GUARD
+#include <stdio.h>
+#endif
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
-void mem_init(size_t size) 
+
+#define NUM_SIZE_CLASSES 32     // Power-of-two size classes: class i holds free blocks of size [2^i, 2^(i+1))
+#define NUM_SHARDS 4            // Independently locked allocator shards; chunks are assigned round-robin
+#define MAGAZINE_CAPACITY 16    // Blocks a thread may park in its local magazine
+#define MAGAZINE_MAX_SIZE 1024  // Only blocks up to this size are cached per thread
+#define MAGAZINE_REFILL 4       // Extra exact-size blocks pulled into the magazine per global refill
+#define CACHE_LINE_SIZE 64      // Placement granularity for small objects and the default SIMD alignment
+
+#define MAX_CHUNKS 48                           // Enough for the doubling policy to reach any practical pool size
+#define INITIAL_CHUNK_SIZE (64 * 1024)          // First chunk committed by mem_init for large pools
+#define SINGLE_CHUNK_THRESHOLD (256 * 1024)     // Pools up to this are committed whole so near-pool-size requests still fit
+#define HEADER_SLAB_COUNT 512                   // Block headers carved from one slab allocation
+#define MAP_INITIAL_CAPACITY 256                // Starting entry count of a shard's pointer-to-header map
+#define HUGE_PAGE_SIZE (2UL * 1024 * 1024)      // Explicit huge page granularity on x86-64
+#define POOL_FILE_MAGIC 0x4c4f4f504d454dUL      // "MEMPOOL" tag of a pool file
+#define POOL_FILE_VERSION 1
+#define POOL_FILE_PAYLOAD_OFFSET 4096           // Payload starts one page in, after the file header
+
+
+// One committed slice of the pool; the pool grows by appending chunks
+typedef struct PoolChunk {
+    char *payload;          // Chunk memory handed out to callers
+    size_t size;            // Bytes in this chunk
+    size_t mapped_size;     // mmap length to release, or 0 when malloc-backed
+    int file_backed;        // 1 when the chunk lives inside the pool file mapping
+    int shard_index;        // Shard owning every block in this chunk
+} PoolChunk;
+
+
+// On-disk layout of a persistent pool: the header page, the payload, then
+// the block table appended by mem_snapshot. Headers are stored as offsets
+// into the payload, so a restart rebuilds the allocator state in one pass.
+typedef struct PoolFileHeader {
+    size_t magic;
+    size_t version;
+    char *payload_base;     // Address the payload was mapped at when snapshotted
+    size_t size;            // Payload bytes
+    size_t block_count;     // Entries in the block table, 0 until a snapshot exists
+} PoolFileHeader;
+
+typedef struct PoolFileBlock {
+    size_t offset;          // Block start, relative to the payload
+    size_t size;
+    int is_free;
+} PoolFileBlock;
+
+
+// Slab of Block headers. Header memory grows with the number of live blocks
+// instead of one header slot per pool byte, and headers of merged-away
+// blocks are recycled before a new slab is allocated.
+typedef struct HeaderSlab {
+    struct HeaderSlab *next;
+    Block headers[HEADER_SLAB_COUNT];
+} HeaderSlab;
+
+
+// One entry of the open-addressing map from payload address to header.
+// An entry whose header no longer points back at the key is stale (the
+// block was merged away) and its slot is reused by later insertions.
+typedef struct HeaderMapEntry {
+    char *key;              // Payload address, or NULL while the slot is empty
+    Block *header;
+} HeaderMapEntry;
+
+
+// Pointer-to-header map of one shard. Readers probe without a lock, so the
+// capacity travels with the entries and outgrown maps are retired onto a
+// chain instead of freed until mem_deinit.
+typedef struct HeaderMap {
+    size_t capacity;                // Number of entries, always a power of two
+    struct HeaderMap *retired_next; // Chain of maps this one replaced
+    HeaderMapEntry entries[];
+} HeaderMap;
+
+
+// One independently locked part of the allocator with its own segregated
+// free lists, header storage and payload-to-header map
+typedef struct Shard {
+    pthread_mutex_t lock;
+    Block *free_heads[NUM_SIZE_CLASSES];    // Segregated free lists, one head per size class
+    unsigned int free_mask;                 // Bit per size class, set while its free list is non-empty
+    HeaderMap *map;                         // Maps payload addresses to their headers
+    size_t map_used;                        // Entries that have ever left the empty state
+    HeaderSlab *slabs;                      // All header slabs owned by this shard
+    int slab_used;                          // Headers handed out of the newest slab
+    Block *spare_headers;                   // Recycled headers, linked through next_free
+} Shard;
+
+
+#ifndef LOCKFREE
+// Per-thread magazine of recently freed small blocks, served without the shard locks.
+// The lock is uncontended on the owner's fast path; other threads only take it
+// when scavenging parked blocks back after a global allocation miss.
+typedef struct ThreadCache {
+    pthread_mutex_t lock;
+    Block *blocks[MAGAZINE_CAPACITY];
+    int count;
+    unsigned generation;                    // Pool generation these entries belong to
+    int active;                             // 1 while owned by a live thread
+    struct ThreadCache *next;               // Registry link
+} ThreadCache;
+#endif
+
+#ifdef LOCKFREE
+// Head of a lock-free per-class stack of parked blocks. The tag is bumped on
+// every successful update so a block popped, reused and pushed again cannot
+// satisfy a stale compare-and-swap (ABA protection).
+typedef struct {
+    Block *head;
+    uintptr_t tag;
+} FreeStackHead;
+#endif
+
+
+static size_t pool_size = 0;                          // Capacity cap given to mem_init; chunks are committed up to this
+static size_t committed_size = 0;                     // Bytes committed across all chunks so far
+static PoolChunk chunks[MAX_CHUNKS];
+static int num_chunks = 0;
+static pthread_mutex_t grow_lock = PTHREAD_MUTEX_INITIALIZER;
+static mem_init_options pool_options = { 0, 0, 0, -1 };     // How chunk memory is obtained and placed
+static int pool_fd = -1;                              // Pool file descriptor, or -1 when not file-backed
+static char *pool_file_base = NULL;                   // Start of the pool file mapping (header page)
+static size_t pool_file_map_len = 0;
+
+// Statistics counters, updated with relaxed atomics on the hot paths and
+// read by mem_stats; reset whenever a pool is (re)initialized
+static size_t stat_alloc_count = 0;
+static size_t stat_free_count = 0;
+static size_t stat_failed_allocs = 0;
+static size_t stat_live_bytes = 0;
+static size_t stat_live_blocks = 0;
+static size_t stat_request_histogram[MEM_STATS_SIZE_BUCKETS];
+
+#define STAT_ADD(counter, amount) __atomic_fetch_add(&(counter), (amount), __ATOMIC_RELAXED)
+#define STAT_SUB(counter, amount) __atomic_fetch_sub(&(counter), (amount), __ATOMIC_RELAXED)
+static Shard shards[NUM_SHARDS];
+
+#ifndef LOCKFREE
+static ThreadCache *cache_registry = NULL;            // All thread caches ever created, for scavenging
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned pool_generation = 0;                  // Bumped by mem_init/mem_deinit to invalidate thread caches
+static __thread ThreadCache *my_cache = NULL;
+static pthread_key_t cache_key;
+static pthread_once_t cache_key_once = PTHREAD_ONCE_INIT;
+#else
+static _Atomic FreeStackHead lf_stacks[NUM_SIZE_CLASSES];   // Lock-free stacks of parked small blocks
+#endif
+
+
+// Maps a block size to its power-of-two size class
+static int size_class_of(size_t size)
 {
-    memory_pool = (char*)malloc(size); 
-    header_pool = (char*)malloc(size * sizeof(Block)); 
+    int class_index = 0;
+    while (class_index < NUM_SIZE_CLASSES - 1 && ((size_t)1 << (class_index + 1)) <= size)
+    {
+        class_index++;
+    }
+    return class_index;
+}
 
-    if (!memory_pool || !header_pool) 
+
+// Returns the chunk containing the given address, or NULL. The chunk table
+// is append-only and published with a release store, so readers may scan it
+// while another thread is growing the pool.
+static PoolChunk* chunk_of(const char *ptr)
+{
+    int count = __atomic_load_n(&num_chunks, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < count; i++)
     {
-        exit(EXIT_FAILURE);
+        if (ptr >= chunks[i].payload && ptr < chunks[i].payload + chunks[i].size)
+        {
+            return &chunks[i];
+        }
     }
+    return NULL;
+}
+
+
+// Returns the shard owning the pool byte at the given address
+static Shard* shard_of_ptr(const char *ptr)
+{
+    PoolChunk *chunk = chunk_of(ptr);
+    return chunk ? &shards[chunk->shard_index] : NULL;
+}
 
-    free_list = (Block*)header_pool;         
-    free_list->size_of_block = size;      
-    free_list->is_free = 1;              
-    free_list->next_block = NULL;            
-    free_list->data = memory_pool;     
+
+// Mixes a payload address into a map bucket index (splitmix64 finalizer)
+static size_t hash_ptr(const char *ptr)
+{
+    size_t hash = (size_t)ptr;
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9UL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebUL;
+    hash ^= hash >> 31;
+    return hash;
 }
 
 
-void* mem_alloc(size_t size) 
+static HeaderMap* map_create(size_t capacity)
 {
-    pthread_mutex_lock(&memory_lock);
+    HeaderMap *map = (HeaderMap*)calloc(1, sizeof(HeaderMap) + capacity * sizeof(HeaderMapEntry));
+    if (map)
+    {
+        map->capacity = capacity;
+    }
+    return map;
+}
 
 
-    if (!memory_pool || !header_pool)
+// Finds the header registered for a payload address without locking: keys
+// are published with release stores, slots never return to the empty state,
+// and replaced maps stay allocated, so a concurrent probe always walks a
+// consistent table. Stale hits are rejected by the data check in header_of.
+static Block* map_lookup(Shard *shard, const char *key)
+{
+    HeaderMap *map = __atomic_load_n(&shard->map, __ATOMIC_ACQUIRE);
+    if (!map)
     {
-        pthread_mutex_unlock(&memory_lock);
         return NULL;
     }
+    size_t mask = map->capacity - 1;
+    for (size_t i = hash_ptr(key) & mask, probes = 0; probes < map->capacity; i = (i + 1) & mask, probes++)
+    {
+        char *slot_key = __atomic_load_n(&map->entries[i].key, __ATOMIC_ACQUIRE);
+        if (slot_key == NULL)
+        {
+            return NULL;
+        }
+        if (slot_key == key)
+        {
+            return map->entries[i].header;
+        }
+    }
+    return NULL;
+}
 
-    if (size == 0)
+
+// Writes an entry into the given map, reusing a stale or matching slot on
+// the probe path before consuming an empty one (shard lock held)
+static void map_place(HeaderMap *map, char *key, Block *header, size_t *used)
+{
+    size_t mask = map->capacity - 1;
+    for (size_t i = hash_ptr(key) & mask; ; i = (i + 1) & mask)
     {
-        Block *current_block = free_list;
-        while (current_block) 
+        HeaderMapEntry *entry = &map->entries[i];
+        char *slot_key = entry->key;
+        if (slot_key == NULL || slot_key == key || entry->header->data != slot_key)
         {
-            if (current_block->is_free) 
+            entry->header = header;
+            __atomic_store_n(&entry->key, key, __ATOMIC_RELEASE);
+            if (slot_key == NULL && used)
             {
-                void *result = current_block->data;
-                pthread_mutex_unlock(&memory_lock);
-                return result;
+                (*used)++;
             }
-            current_block = current_block->next_block;
+            return;
         }
-        pthread_mutex_unlock(&memory_lock);
-        return NULL;
     }
+}
 
-    Block *current_block = free_list;
-    Block *best_fit = NULL;
-    Block *prev_best = NULL;
-    Block *prev = NULL;
 
-    while (current_block) 
+// Registers a block's payload address in its shard's map, rehashing into a
+// fresh table when the current one runs out of empty slots (shard lock held)
+static void map_insert(Shard *shard, char *key, Block *header)
+{
+    HeaderMap *map = shard->map;
+    if (shard->map_used * 4 >= map->capacity * 3)
     {
-        if (current_block->is_free && current_block->size_of_block >= size) 
+        // Count the live entries to size the new table; stale ones are dropped
+        size_t live = 0;
+        for (size_t i = 0; i < map->capacity; i++)
+        {
+            char *slot_key = map->entries[i].key;
+            if (slot_key && map->entries[i].header->data == slot_key)
+            {
+                live++;
+            }
+        }
+        size_t new_capacity = MAP_INITIAL_CAPACITY;
+        while (live * 2 >= new_capacity)
+        {
+            new_capacity *= 2;
+        }
+        HeaderMap *new_map = map_create(new_capacity);
+        if (new_map)
         {
-            if (!best_fit || current_block->size_of_block < best_fit->size_of_block) 
+            size_t used = 0;
+            for (size_t i = 0; i < map->capacity; i++)
             {
-                best_fit = current_block;
-                prev_best = prev;
+                char *slot_key = map->entries[i].key;
+                if (slot_key && map->entries[i].header->data == slot_key)
+                {
+                    map_place(new_map, slot_key, map->entries[i].header, &used);
+                }
             }
+            new_map->retired_next = map;        // Keep the old table alive for in-flight readers
+            shard->map_used = used;
+            __atomic_store_n(&shard->map, new_map, __ATOMIC_RELEASE);
+            map = new_map;
         }
-        prev = current_block;
-        current_block = current_block->next_block;
     }
+    map_place(map, key, header, &shard->map_used);
+}
 
-    if (best_fit) 
+
+// Hands out a Block header, reusing a recycled one before carving a new
+// slot out of the shard's newest slab (shard lock held)
+static Block* header_alloc(Shard *shard)
+{
+    if (shard->spare_headers)
     {
-        if (best_fit->size_of_block > size + sizeof(Block)) 
+        Block *header = shard->spare_headers;
+        shard->spare_headers = header->next_free;
+        header->next_free = NULL;
+        return header;
+    }
+    if (!shard->slabs || shard->slab_used == HEADER_SLAB_COUNT)
+    {
+        HeaderSlab *slab = (HeaderSlab*)malloc(sizeof(HeaderSlab));
+        if (!slab)
         {
-            Block *new_block = (Block*)((char*)best_fit + sizeof(Block));
-            new_block->size_of_block = best_fit->size_of_block - size;
-            new_block->is_free = 1;
-            new_block->next_block = best_fit->next_block;
-            new_block->data = best_fit->data + size;
-            
-            best_fit->size_of_block = size;
-            best_fit->next_block = new_block;
-
-            if (!prev_best) {
-                free_list = new_block; 
-            }
+            return NULL;
         }
+        slab->next = shard->slabs;
+        shard->slabs = slab;
+        shard->slab_used = 0;
+    }
+    return &shard->slabs->headers[shard->slab_used++];
+}
+
 
-        best_fit->is_free = 0;
+// Recycles the header of a merged-away block; clearing data makes its map
+// entry stale so later insertions can reclaim the slot (shard lock held)
+static void header_release(Shard *shard, Block *header)
+{
+    header->data = NULL;
+    header->next_free = shard->spare_headers;
+    shard->spare_headers = header;
+}
 
-        void *result = best_fit->data;
-        pthread_mutex_unlock(&memory_lock);
-        return result;
+
+// Looks up the header of an allocated or free payload pointer through its
+// shard's map, or returns NULL if the pointer does not mark the start of a
+// managed block. Safe without a lock: an allocated block's entry is stable.
+static Block* header_of(void *block)
+{
+    Shard *shard = shard_of_ptr((char*)block);
+    if (!shard)
+    {
+        return NULL;
+    }
+    Block *header = map_lookup(shard, (const char*)block);
+    if (!header || header->data != (char*)block)
+    {
+        return NULL;        // No block starts at this address
     }
+    return header;
+}
 
-    pthread_mutex_unlock(&memory_lock);
-    return NULL;
+
+#ifdef DEBUG_GUARD
+// Guarded staging build: every allocation is inflated by one canary word
+// placed in the last bytes of the block and checked when the block comes
+// back, double frees and frees of pointers the pool does not own abort
+// with the allocating callsite, and mem_deinit reports unfreed blocks.
+// None of this exists in the release build.
+#define GUARD_REDZONE 8
+
+static const unsigned long long guard_canary = 0xDEADC0DEDEADC0DEULL;
+
+// Pool capacity as the caller requested it, before the redzone headroom was
+// added on top. Allocations are budgeted against this figure so a guarded
+// pool refuses a request at the same point the release build would instead
+// of lending out the headroom reserved for the canaries.
+static size_t guard_nominal_capacity = 0;
+
+// Returns whether a request of `size` payload bytes fits the nominal byte
+// budget; the redzones carried by live blocks are excluded from the tally
+static int guard_budget_ok(size_t size)
+{
+    size_t live_bytes = __atomic_load_n(&stat_live_bytes, __ATOMIC_RELAXED);
+    size_t live_blocks = __atomic_load_n(&stat_live_blocks, __ATOMIC_RELAXED);
+    return live_bytes - live_blocks * GUARD_REDZONE + size <= guard_nominal_capacity;
+}
+
+// Reports a guard violation and aborts; the owner address resolves to the
+// allocating callsite with addr2line against the running binary
+static void guard_fail(const char *what, const void *ptr, const Block *header)
+{
+    fprintf(stderr, "DEBUG_GUARD: %s: pointer %p", what, ptr);
+    if (header && header->guard_owner)
+    {
+        fprintf(stderr, " (block of %zu bytes allocated from %p)",
+                header->size_of_block - GUARD_REDZONE, header->guard_owner);
+    }
+    fprintf(stderr, "\n");
+    abort();
 }
 
 
-void mem_free(void* block) 
+// Arms the rear canary and records the allocating callsite
+static void guard_arm(Block *header, void *owner)
 {
-    pthread_mutex_lock(&memory_lock);
+    memcpy(header->data + header->size_of_block - GUARD_REDZONE, &guard_canary, GUARD_REDZONE);
+    header->guard_owner = owner;
+}
+
 
-    if (!block || !memory_pool || !header_pool) 
+// Verifies the rear canary of an allocated block before it is released
+static void guard_check(const Block *header, const void *ptr)
+{
+    if (memcmp(header->data + header->size_of_block - GUARD_REDZONE, &guard_canary, GUARD_REDZONE) != 0)
     {
-        pthread_mutex_unlock(&memory_lock);
-        return;
+        guard_fail("buffer overflow past the end of a block", ptr, header);
     }
+}
+#endif
 
-    // Find the corresponding Block in the header_pool
-    Block *block_to_free = NULL;
-    Block *current = free_list;
-    Block *prev = NULL;
 
-    while (current) {
-        if (current->data == block) {
-            block_to_free = current;
-            break;
+// Pushes a free block onto the head of its size-class list (shard lock held)
+static void free_list_insert(Shard *shard, Block *block)
+{
+    int class_index = size_class_of(block->size_of_block);
+    block->prev_free = NULL;
+    block->next_free = shard->free_heads[class_index];
+    if (shard->free_heads[class_index])
+    {
+        shard->free_heads[class_index]->prev_free = block;
+    }
+    shard->free_heads[class_index] = block;
+    shard->free_mask |= 1u << class_index;
+}
+
+
+// Unlinks a free block from its size-class list (shard lock held)
+static void free_list_remove(Shard *shard, Block *block)
+{
+    int class_index = size_class_of(block->size_of_block);
+    if (block->prev_free)
+    {
+        block->prev_free->next_free = block->next_free;
+    }
+    else
+    {
+        shard->free_heads[class_index] = block->next_free;
+    }
+    if (block->next_free)
+    {
+        block->next_free->prev_free = block->prev_free;
+    }
+    block->next_free = NULL;
+    block->prev_free = NULL;
+    if (!shard->free_heads[class_index])
+    {
+        shard->free_mask &= ~(1u << class_index);
+    }
+}
+
+
+// Carves a block of the requested size out of the shard, or returns NULL (shard lock held)
+static Block* alloc_from_shard(Shard *shard, size_t size)
+{
+    int start_class = size_class_of(size);
+    unsigned int eligible = shard->free_mask & (~0u << start_class);
+    Block *found = NULL;
+
+    // Best fit within the request's own class, the only class that can also
+    // hold blocks smaller than the request
+    if (eligible & (1u << start_class))
+    {
+        for (Block *current_block = shard->free_heads[start_class]; current_block;
+             current_block = current_block->next_free)
+        {
+            if (current_block->size_of_block >= size
+                && (!found || current_block->size_of_block < found->size_of_block))
+            {
+                found = current_block;
+                if (found->size_of_block == size)
+                {
+                    break;      // An exact fit cannot be beaten
+                }
+            }
         }
-        prev = current;
-        current = current->next_block;
+        eligible &= ~(1u << start_class);
     }
 
-    if (!block_to_free) {
-        // Block not found in our managed memory
-        pthread_mutex_unlock(&memory_lock);
-        return;
+    // Every block in a higher class fits; the mask jumps straight to the
+    // lowest non-empty one so the split remainder is as small as possible,
+    // and allocated blocks are never touched during the search
+    if (!found && eligible)
+    {
+        found = shard->free_heads[__builtin_ctz(eligible)];
     }
 
-    // Mark the block as free
+    if (!found)
+    {
+        return NULL;
+    }
+
+    free_list_remove(shard, found);
+
+    // Split off the remainder into its own free block
+    if (found->size_of_block > size)
+    {
+        Block *new_block = header_alloc(shard);
+        if (new_block)
+        {
+            new_block->size_of_block = found->size_of_block - size;
+            new_block->is_free = 1;
+            new_block->next_block = found->next_block;
+            new_block->prev_block = found;
+            new_block->data = found->data + size;
+            if (new_block->next_block)
+            {
+                new_block->next_block->prev_block = new_block;
+            }
+            map_insert(shard, new_block->data, new_block);
+            free_list_insert(shard, new_block);
+
+            found->size_of_block = size;
+            found->next_block = new_block;
+        }
+        // Out of header memory: hand out the whole block unsplit
+    }
+
+    found->is_free = 0;
+    return found;
+}
+
+
+// Returns an allocated block to the shard and coalesces with its neighbors (shard lock held)
+static void free_into_shard(Shard *shard, Block *block_to_free)
+{
     block_to_free->is_free = 1;
 
     // Merge with next block if it's free
-    if (block_to_free->next_block && block_to_free->next_block->is_free) {
-        block_to_free->size_of_block += block_to_free->next_block->size_of_block;
-        block_to_free->next_block = block_to_free->next_block->next_block;
+    if (block_to_free->next_block && block_to_free->next_block->is_free == 1) {
+        Block *next = block_to_free->next_block;
+        free_list_remove(shard, next);
+        block_to_free->size_of_block += next->size_of_block;
+        block_to_free->next_block = next->next_block;
+        if (next->next_block) {
+            next->next_block->prev_block = block_to_free;
+        }
+        header_release(shard, next);    // Invalidate the absorbed header
     }
 
-    // Merge with previous block if it's free
-    if (prev && prev->is_free) {
+    // Merge with previous block if it's free; physical chains never cross chunks
+    Block *prev = block_to_free->prev_block;
+    if (prev && prev->is_free == 1) {
+        free_list_remove(shard, prev);
         prev->size_of_block += block_to_free->size_of_block;
         prev->next_block = block_to_free->next_block;
+        if (block_to_free->next_block) {
+            block_to_free->next_block->prev_block = prev;
+        }
+        header_release(shard, block_to_free);   // Invalidate the absorbed header
         block_to_free = prev;
     }
 
-    pthread_mutex_unlock(&memory_lock);
+    free_list_insert(shard, block_to_free);
 }
 
 
-void* mem_resize(void* block, size_t size) 
+// Frees an allocated block into its owning shard, taking the shard lock
+static void free_block_global(Block *block)
 {
-    pthread_mutex_lock(&memory_lock);
+    Shard *shard = shard_of_ptr(block->data);
+    if (!shard)
+    {
+        return;
+    }
+    pthread_mutex_lock(&shard->lock);
+    free_into_shard(shard, block);
+    pthread_mutex_unlock(&shard->lock);
+}
 
-    if (!block) {
-        void* result = mem_alloc(size);
-        pthread_mutex_unlock(&memory_lock);
-        return result;
+
+// Re-cuts a freshly carved block so its payload starts on an alignment
+// boundary and spans exactly want bytes: the misaligned prefix and the
+// trailing slack are split off and handed straight back to the free lists,
+// so alignment costs headers and transient contiguity, not capacity. The
+// block keeps its map identity through a re-insert under the new address.
+// Returns the block, aligned unless header memory ran out.
+static Block *carve_aligned(Shard *shard, Block *block, size_t alignment, size_t want)
+{
+    char *raw = block->data;
+    char *aligned = (char*)(((size_t)raw + (alignment - 1)) & ~(alignment - 1));
+    size_t prefix = (size_t)(aligned - raw);
+    if (prefix > 0)
+    {
+        Block *head = header_alloc(shard);
+        if (!head)
+        {
+            return block;       // No header for the split; caller sees the raw placement
+        }
+        head->size_of_block = prefix;
+        head->is_free = 0;
+        head->data = raw;
+        head->prev_block = block->prev_block;
+        head->next_block = block;
+        if (head->prev_block)
+        {
+            head->prev_block->next_block = head;
+        }
+        block->prev_block = head;
+        block->data = aligned;
+        block->size_of_block -= prefix;
+        map_insert(shard, raw, head);       // Replaces the block's old entry in place
+        map_insert(shard, aligned, block);
+        free_into_shard(shard, head);
     }
 
-    if (size == 0) 
+    size_t slack = block->size_of_block - want;
+    if (slack > 0)
     {
-        mem_free(block);
-        pthread_mutex_unlock(&memory_lock);
-        return NULL;
+        Block *tail = header_alloc(shard);
+        if (tail)
+        {
+            tail->size_of_block = slack;
+            tail->is_free = 0;
+            tail->data = block->data + want;
+            tail->prev_block = block;
+            tail->next_block = block->next_block;
+            if (tail->next_block)
+            {
+                tail->next_block->prev_block = tail;
+            }
+            block->next_block = tail;
+            block->size_of_block = want;
+            map_insert(shard, tail->data, tail);
+            free_into_shard(shard, tail);
+        }
     }
 
-    Block* old_block = (Block*)((char*)block - sizeof(Block));
+    return block;
+}
 
-    if (old_block->size_of_block >= size) {
-        pthread_mutex_unlock(&memory_lock);
-        return block;
+
+// Scans the shards for a free block that can hold size bytes starting at an
+// aligned address, carving it under the same lock acquisition as the search
+// so no other thread can allocate a neighbour between the find and the trim
+// and strand the alignment slack between live blocks. In zero_cost mode a
+// candidate only qualifies when aligning wastes nothing: its start is
+// already aligned, or the skipped prefix merges back into a free previous
+// neighbour. May return a block whose data is not aligned when header
+// memory runs out mid-split.
+static Block *alloc_aligned_from_shards(size_t size, size_t alignment, int zero_cost)
+{
+    size_t home = ((size_t)pthread_self() >> 6) % NUM_SHARDS;
+    for (int i = 0; i < NUM_SHARDS; i++)
+    {
+        Shard *shard = &shards[(home + i) % NUM_SHARDS];
+        pthread_mutex_lock(&shard->lock);
+
+        // Best fit among the blocks that can serve the aligned carve
+        Block *found = NULL;
+        unsigned int eligible = shard->free_mask & (~0u << size_class_of(size));
+        while (eligible)
+        {
+            int class_index = __builtin_ctz(eligible);
+            eligible &= eligible - 1;
+            for (Block *current_block = shard->free_heads[class_index]; current_block;
+                 current_block = current_block->next_free)
+            {
+                size_t prefix = (alignment - (size_t)current_block->data) & (alignment - 1);
+                if (current_block->size_of_block < prefix + size)
+                {
+                    continue;
+                }
+                if (zero_cost && prefix > 0
+                    && (!current_block->prev_block || current_block->prev_block->is_free != 1))
+                {
+                    continue;       // The skipped prefix would be stranded next to a live block
+                }
+                if (!found || current_block->size_of_block < found->size_of_block)
+                {
+                    found = current_block;
+                }
+            }
+        }
+
+        if (found)
+        {
+            free_list_remove(shard, found);
+            found->is_free = 0;
+            found = carve_aligned(shard, found, alignment, size);
+            pthread_mutex_unlock(&shard->lock);
+            return found;
+        }
+        pthread_mutex_unlock(&shard->lock);
     }
+    return NULL;
+}
 
-    void* new_block = mem_alloc(size);
 
-    if (new_block) 
+// Obtains backing memory for one chunk according to the pool options,
+// degrading gracefully when a placement request cannot be honored: explicit
+// huge pages fall back to a normal mapping with a transparent-huge-page
+// hint, and the mmap path falls back to malloc. On success *mapped_size
+// holds the mmap length to release later, or 0 for malloc-backed memory.
+static char* chunk_acquire(size_t size, size_t *mapped_size)
+{
+    *mapped_size = 0;
+    if (pool_options.use_mmap || pool_options.use_huge_pages || pool_options.use_thp)
+    {
+        size_t length = size;
+        char *payload = (char*)MAP_FAILED;
+#ifdef MAP_HUGETLB
+        if (pool_options.use_huge_pages)
+        {
+            length = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+            payload = (char*)mmap(NULL, length, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        }
+#endif
+        if (payload == (char*)MAP_FAILED)
+        {
+            length = size;
+            payload = (char*)mmap(NULL, length, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+            if (payload != (char*)MAP_FAILED && (pool_options.use_thp || pool_options.use_huge_pages))
+            {
+                madvise(payload, length, MADV_HUGEPAGE);    // Best effort; THP may be disabled system-wide
+            }
+#endif
+        }
+        if (payload != (char*)MAP_FAILED)
+        {
+#ifdef SYS_mbind
+            if (pool_options.numa_node >= 0)
+            {
+                unsigned long nodemask = 1UL << pool_options.numa_node;
+                // MPOL_BIND (2): fault this chunk's pages on the requested node
+                syscall(SYS_mbind, payload, length, 2, &nodemask,
+                        sizeof(nodemask) * 8 + 1, 0);
+            }
+#endif
+            *mapped_size = length;
+            return payload;
+        }
+    }
+    void *payload = NULL;
+    // Cache-line-aligned chunk bases let small aligned blocks pack with no
+    // slack: consecutive cache-line-sized carves land on line boundaries
+    // naturally instead of stranding sub-line fragments between them.
+    if (posix_memalign(&payload, CACHE_LINE_SIZE, size) != 0)
+    {
+        payload = malloc(size);
+    }
+    return (char*)payload;
+}
+
+
+// Releases one chunk's backing memory the way it was obtained; chunks
+// inside the pool file are unmapped with the whole file by mem_deinit
+static void chunk_release(PoolChunk *chunk)
+{
+    if (chunk->file_backed)
     {
-        memcpy(new_block, block, old_block->size_of_block); 
-        mem_free(block);                                  
+        chunk->payload = NULL;
+        return;
     }
-    
-    pthread_mutex_unlock(&memory_lock);
-    return new_block;
+    if (chunk->mapped_size)
+    {
+        munmap(chunk->payload, chunk->mapped_size);
+    }
+    else
+    {
+        free(chunk->payload);
+    }
+    chunk->payload = NULL;
+    chunk->mapped_size = 0;
+}
+
+
+// Commits one more chunk of pool memory, at least min_size bytes, following
+// a doubling policy capped at the capacity given to mem_init. Returns 1 on
+// success. Called without any shard lock held.
+static int grow_pool(size_t min_size)
+{
+    int success = 0;
+    pthread_mutex_lock(&grow_lock);
+    if (num_chunks < MAX_CHUNKS && min_size > 0 && min_size <= pool_size - committed_size)
+    {
+        size_t chunk_size = committed_size;     // Doubling: each chunk matches everything committed before it
+        if (chunk_size < min_size)
+        {
+            chunk_size = min_size;
+        }
+        if (chunk_size > pool_size - committed_size)
+        {
+            chunk_size = pool_size - committed_size;
+        }
+
+        size_t mapped_size = 0;
+        char *payload = chunk_acquire(chunk_size, &mapped_size);
+        if (payload)
+        {
+            PoolChunk *chunk = &chunks[num_chunks];
+            chunk->payload = payload;
+            chunk->size = chunk_size;
+            chunk->mapped_size = mapped_size;
+            chunk->file_backed = 0;
+            chunk->shard_index = num_chunks % NUM_SHARDS;
+
+            // The chunk starts as one free block in its shard; the chunk table
+            // entry is published only once the block is reachable
+            Shard *shard = &shards[chunk->shard_index];
+            pthread_mutex_lock(&shard->lock);
+            Block *initial = header_alloc(shard);
+            if (initial)
+            {
+                initial->size_of_block = chunk_size;
+                initial->is_free = 1;
+                initial->next_block = NULL;
+                initial->prev_block = NULL;
+                initial->data = payload;
+                map_insert(shard, payload, initial);
+                free_list_insert(shard, initial);
+                committed_size += chunk_size;
+                __atomic_store_n(&num_chunks, num_chunks + 1, __ATOMIC_RELEASE);
+                success = 1;
+            }
+            pthread_mutex_unlock(&shard->lock);
+            if (!success)
+            {
+                chunk_release(chunk);
+            }
+        }
+    }
+    pthread_mutex_unlock(&grow_lock);
+    return success;
+}
+
+
+#ifndef LOCKFREE
+// Drops or flushes a thread cache's parked blocks (cache lock held)
+static void flush_cache(ThreadCache *cache)
+{
+    if (cache->generation == pool_generation)
+    {
+        for (int i = 0; i < cache->count; i++)
+        {
+            cache->blocks[i]->is_free = 0;
+            free_block_global(cache->blocks[i]);
+        }
+    }
+    cache->count = 0;           // Stale generations are simply dropped; their pool is gone
+    cache->generation = pool_generation;
+}
+
+
+// Thread-exit destructor: return parked blocks and release the cache for reuse
+static void cache_destructor(void *arg)
+{
+    ThreadCache *cache = (ThreadCache*)arg;
+    pthread_mutex_lock(&cache->lock);
+    flush_cache(cache);
+    cache->active = 0;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+
+static void create_cache_key(void)
+{
+    pthread_key_create(&cache_key, cache_destructor);
 }
 
 
-void mem_deinit() 
+// Returns the calling thread's magazine, claiming an idle one or creating it
+static ThreadCache* get_cache(void)
 {
-    pthread_mutex_lock(&memory_lock); 
-    free(memory_pool); 
-    free(header_pool); 
-    memory_pool = NULL; 
-    header_pool = NULL; 
-    free_list = NULL;   
+    if (my_cache)
+    {
+        return my_cache;
+    }
+
+    pthread_once(&cache_key_once, create_cache_key);
+
+    pthread_mutex_lock(&registry_lock);
+    for (ThreadCache *cache = cache_registry; cache; cache = cache->next)
+    {
+        if (!cache->active)
+        {
+            cache->active = 1;
+            my_cache = cache;
+            break;
+        }
+    }
+    if (!my_cache)
+    {
+        ThreadCache *cache = (ThreadCache*)malloc(sizeof(ThreadCache));
+        if (cache)
+        {
+            pthread_mutex_init(&cache->lock, NULL);
+            cache->count = 0;
+            cache->generation = pool_generation;
+            cache->active = 1;
+            cache->next = cache_registry;
+            cache_registry = cache;
+            my_cache = cache;
+        }
+    }
+    pthread_mutex_unlock(&registry_lock);
 
-    pthread_mutex_unlock(&memory_lock); 
-    pthread_mutex_destroy(&memory_lock); 
+    if (my_cache)
+    {
+        pthread_setspecific(cache_key, my_cache);
+    }
+    return my_cache;
+}
+
+
+// Reclaims blocks parked in every thread's magazine back into the shards,
+// so a global allocation miss can still use memory another thread freed
+static void scavenge_caches(void)
+{
+    pthread_mutex_lock(&registry_lock);
+    for (ThreadCache *cache = cache_registry; cache; cache = cache->next)
+    {
+        pthread_mutex_lock(&cache->lock);
+        flush_cache(cache);
+        pthread_mutex_unlock(&cache->lock);
+    }
+    pthread_mutex_unlock(&registry_lock);
+}
+#endif
+
+
+#ifdef LOCKFREE
+// Parks a freed block on its class's lock-free stack without taking any lock
+static void lf_push(Block *block)
+{
+    int class_index = size_class_of(block->size_of_block);
+    FreeStackHead old_head = atomic_load(&lf_stacks[class_index]);
+    FreeStackHead new_head;
+    do
+    {
+        block->next_free = old_head.head;
+        new_head.head = block;
+        new_head.tag = old_head.tag + 1;
+    }
+    while (!atomic_compare_exchange_weak(&lf_stacks[class_index], &old_head, new_head));
+}
+
+
+// Pops a parked block of exactly the requested size, or returns NULL.
+// Reading through a block that loses the race is safe: headers are never
+// unmapped, and the tag makes a stale compare-and-swap fail.
+static Block* lf_pop(size_t size)
+{
+    int class_index = size_class_of(size);
+    FreeStackHead old_head = atomic_load(&lf_stacks[class_index]);
+    FreeStackHead new_head;
+    while (old_head.head && old_head.head->size_of_block == size)
+    {
+        new_head.head = old_head.head->next_free;
+        new_head.tag = old_head.tag + 1;
+        if (atomic_compare_exchange_weak(&lf_stacks[class_index], &old_head, new_head))
+        {
+            return old_head.head;
+        }
+    }
+    return NULL;
+}
+
+
+// Swaps every lock-free stack empty and returns the parked blocks to their
+// shards with full coalescing; run when the shards cannot satisfy a request
+static void lf_drain(void)
+{
+    for (int class_index = 0; class_index < NUM_SIZE_CLASSES; class_index++)
+    {
+        FreeStackHead old_head = atomic_load(&lf_stacks[class_index]);
+        FreeStackHead new_head;
+        do
+        {
+            new_head.head = NULL;
+            new_head.tag = old_head.tag + 1;
+        }
+        while (!atomic_compare_exchange_weak(&lf_stacks[class_index], &old_head, new_head));
+
+        Block *current_block = old_head.head;
+        while (current_block)
+        {
+            Block *next_parked = current_block->next_free;
+            current_block->next_free = NULL;
+            current_block->is_free = 0;
+            free_block_global(current_block);
+            current_block = next_parked;
+        }
+    }
+}
+#endif
+
+
+// Recovers blocks parked outside the shards after a global allocation miss
+static void reclaim_parked(void)
+{
+#ifdef LOCKFREE
+    lf_drain();
+#else
+    scavenge_caches();
+#endif
+}
+
+
+void mem_init(size_t size)
+{
+    mem_init_ex(size, NULL);
+}
+
+
+// Shared setup for the init paths: invalidates blocks parked against any
+// previous pool and resets every shard to an empty state
+static void init_pool_state(size_t size)
+{
+    pool_size = size;
+    committed_size = 0;
+    num_chunks = 0;
+
+    stat_alloc_count = 0;
+    stat_free_count = 0;
+    stat_failed_allocs = 0;
+    stat_live_bytes = 0;
+    stat_live_blocks = 0;
+    memset(stat_request_histogram, 0, sizeof(stat_request_histogram));
+
+#ifndef LOCKFREE
+    pool_generation++;          // Invalidate blocks parked in thread caches from a previous pool
+#else
+    for (int class_index = 0; class_index < NUM_SIZE_CLASSES; class_index++)
+    {
+        FreeStackHead empty_head = { NULL, 0 };
+        atomic_store(&lf_stacks[class_index], empty_head);      // Drop stacks pointing into a previous pool
+    }
+#endif
+
+    for (int shard_index = 0; shard_index < NUM_SHARDS; shard_index++)
+    {
+        Shard *shard = &shards[shard_index];
+        pthread_mutex_init(&shard->lock, NULL);
+        for (int class_index = 0; class_index < NUM_SIZE_CLASSES; class_index++)
+        {
+            shard->free_heads[class_index] = NULL;
+        }
+        shard->free_mask = 0;
+        shard->map = map_create(MAP_INITIAL_CAPACITY);
+        shard->map_used = 0;
+        shard->slabs = NULL;
+        shard->slab_used = 0;
+        shard->spare_headers = NULL;
+        if (!shard->map)
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+
+void mem_init_ex(size_t size, const mem_init_options *options)
+{
+    static const mem_init_options default_options = { 0, 0, 0, -1 };
+    pool_options = options ? *options : default_options;
+
+#ifdef DEBUG_GUARD
+    // The redzones consume real pool bytes, so give guarded pools matching
+    // physical headroom; guard_budget_ok caps what allocations may take to
+    // the nominal size, so workloads sized to the byte exhaust at the same
+    // point as the release build
+    guard_nominal_capacity = size;
+    if (size > 0)
+    {
+        size += size / 4 + GUARD_REDZONE;
+    }
+#endif
+
+    init_pool_state(size);
+
+    // Commit the first chunk up front. Small pools are committed whole so a
+    // request close to the pool size can still be met from one extent; large
+    // pools start small and grow on demand instead of reserving everything.
+    if (size > 0)
+    {
+        size_t first_chunk = (size <= SINGLE_CHUNK_THRESHOLD) ? size : INITIAL_CHUNK_SIZE;
+        if (!grow_pool(first_chunk))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+
+int mem_init_file(const char *path, size_t size)
+{
+    if (!path || size == 0)
+    {
+        return -1;
+    }
+
+    static const mem_init_options default_options = { 0, 0, 0, -1 };
+    pool_options = default_options;
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    PoolFileHeader file_header;
+    int restoring = pread(fd, &file_header, sizeof(file_header), 0) == (ssize_t)sizeof(file_header)
+                    && file_header.magic == POOL_FILE_MAGIC
+                    && file_header.version == POOL_FILE_VERSION
+                    && file_header.size == size
+                    && file_header.block_count > 0;
+
+    size_t map_len = POOL_FILE_PAYLOAD_OFFSET + size;
+    if (!restoring && ftruncate(fd, (off_t)map_len) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    // When restoring, map the payload back at its recorded address so
+    // pointers stored inside it (list nodes, caller data) stay valid. If the
+    // kernel cannot give us that address the pool is still restored, but
+    // only offset-based consumers of the payload survive.
+    char *hint = restoring ? file_header.payload_base - POOL_FILE_PAYLOAD_OFFSET : NULL;
+    char *base = (char*)mmap(hint, map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == (char*)MAP_FAILED)
+    {
+        close(fd);
+        return -1;
+    }
+
+    init_pool_state(size);
+
+#ifdef DEBUG_GUARD
+    // File pools map exactly the requested bytes, so the nominal budget and
+    // the physical capacity coincide; the redzones come out of both
+    guard_nominal_capacity = size;
+#endif
+
+    pool_fd = fd;
+    pool_file_base = base;
+    pool_file_map_len = map_len;
+
+    char *payload = base + POOL_FILE_PAYLOAD_OFFSET;
+    PoolChunk *chunk = &chunks[0];
+    chunk->payload = payload;
+    chunk->size = size;
+    chunk->mapped_size = 0;
+    chunk->file_backed = 1;
+    chunk->shard_index = 0;
+    committed_size = size;      // The file is committed whole; the pool never grows past it
+
+    Shard *shard = &shards[0];
+    pthread_mutex_lock(&shard->lock);
+    if (restoring)
+    {
+        // Rebuild headers, the physical chain and the free lists from the
+        // block table in one pass; the payload itself is already live
+        Block *prev = NULL;
+        off_t pos = (off_t)map_len;
+        for (size_t i = 0; i < file_header.block_count; i++, pos += sizeof(PoolFileBlock))
+        {
+            PoolFileBlock entry;
+            if (pread(fd, &entry, sizeof(entry), pos) != (ssize_t)sizeof(entry))
+            {
+                break;
+            }
+            Block *block = header_alloc(shard);
+            if (!block)
+            {
+                break;
+            }
+            block->size_of_block = entry.size;
+            block->is_free = entry.is_free ? 1 : 0;
+            block->next_block = NULL;
+            block->prev_block = prev;
+            block->data = payload + entry.offset;
+            if (prev)
+            {
+                prev->next_block = block;
+            }
+            map_insert(shard, block->data, block);
+            if (block->is_free)
+            {
+                free_list_insert(shard, block);
+            }
+            prev = block;
+        }
+    }
+    else
+    {
+        Block *initial = header_alloc(shard);
+        if (!initial)
+        {
+            pthread_mutex_unlock(&shard->lock);
+            mem_deinit();
+            return -1;
+        }
+        initial->size_of_block = size;
+        initial->is_free = 1;
+        initial->next_block = NULL;
+        initial->prev_block = NULL;
+        initial->data = payload;
+        map_insert(shard, payload, initial);
+        free_list_insert(shard, initial);
+    }
+    pthread_mutex_unlock(&shard->lock);
+
+    __atomic_store_n(&num_chunks, 1, __ATOMIC_RELEASE);
+    return restoring ? 1 : 0;
+}
+
+
+int mem_snapshot(void)
+{
+    if (pool_fd < 0 || num_chunks == 0)
+    {
+        return -1;
+    }
+
+    reclaim_parked();       // Parked blocks must be plainly free or allocated in the table
+
+    Shard *shard = &shards[0];
+    pthread_mutex_lock(&shard->lock);
+
+    size_t count = 0;
+    off_t pos = (off_t)pool_file_map_len;
+    for (Block *block = map_lookup(shard, chunks[0].payload); block; block = block->next_block)
+    {
+        PoolFileBlock entry;
+        entry.offset = (size_t)(block->data - chunks[0].payload);
+        entry.size = block->size_of_block;
+        entry.is_free = block->is_free == 1;
+        if (pwrite(pool_fd, &entry, sizeof(entry), pos) != (ssize_t)sizeof(entry))
+        {
+            pthread_mutex_unlock(&shard->lock);
+            return -1;
+        }
+        pos += sizeof(entry);
+        count++;
+    }
+    pthread_mutex_unlock(&shard->lock);
+
+    // Flush the payload before publishing the header that validates it
+    if (msync(pool_file_base, pool_file_map_len, MS_SYNC) != 0)
+    {
+        return -1;
+    }
+    PoolFileHeader file_header;
+    file_header.magic = POOL_FILE_MAGIC;
+    file_header.version = POOL_FILE_VERSION;
+    file_header.payload_base = chunks[0].payload;
+    file_header.size = pool_size;
+    file_header.block_count = count;
+    if (pwrite(pool_fd, &file_header, sizeof(file_header), 0) != (ssize_t)sizeof(file_header))
+    {
+        return -1;
+    }
+    return fsync(pool_fd) == 0 ? 0 : -1;
+}
+
+
+// Tries every shard for a block of the requested size, starting at the
+// thread's home shard, refilling the thread magazine with exact-size
+// siblings under the same lock acquisition on a hit
+static Block* alloc_from_shards(size_t size)
+{
+#ifdef LOCKFREE
+    size_t home = ((size_t)pthread_self() >> 6) % NUM_SHARDS;
+#else
+    ThreadCache *cache = (size <= MAGAZINE_MAX_SIZE) ? get_cache() : NULL;
+    size_t home = cache ? ((size_t)cache / sizeof(ThreadCache)) % NUM_SHARDS : 0;
+    Block *refill[MAGAZINE_REFILL];
+    int refill_count = 0;
+#endif
+
+    Block *found = NULL;
+    for (int i = 0; i < NUM_SHARDS && !found; i++)
+    {
+#ifdef LOCKFREE
+        Shard *shard = &shards[(home + i) % NUM_SHARDS];
+        pthread_mutex_lock(&shard->lock);
+        found = alloc_from_shard(shard, size);
+        pthread_mutex_unlock(&shard->lock);
+#else
+        Shard *shard = &shards[(home + i) % NUM_SHARDS];
+        pthread_mutex_lock(&shard->lock);
+        found = alloc_from_shard(shard, size);
+
+        // Refill the magazine with exact-size siblings under the same lock
+        if (found && cache)
+        {
+            Block *current_block = shard->free_heads[size_class_of(size)];
+            while (current_block && refill_count < MAGAZINE_REFILL)
+            {
+                Block *next_free = current_block->next_free;
+                if (current_block->size_of_block == size)
+                {
+                    free_list_remove(shard, current_block);
+                    current_block->is_free = 2;     // Parked in a magazine
+                    refill[refill_count++] = current_block;
+                }
+                current_block = next_free;
+            }
+        }
+        pthread_mutex_unlock(&shard->lock);
+#endif
+    }
+
+#ifndef LOCKFREE
+    if (refill_count > 0)
+    {
+        pthread_mutex_lock(&cache->lock);
+        for (int i = 0; i < refill_count; i++)
+        {
+            if (cache->generation == pool_generation && cache->count < MAGAZINE_CAPACITY)
+            {
+                cache->blocks[cache->count++] = refill[i];
+                refill[i] = NULL;
+            }
+        }
+        pthread_mutex_unlock(&cache->lock);
+        for (int i = 0; i < refill_count; i++)
+        {
+            if (refill[i])      // Didn't fit in the magazine, hand it back
+            {
+                refill[i]->is_free = 0;
+                free_block_global(refill[i]);
+            }
+        }
+    }
+#endif
+
+    return found;
+}
+
+
+void* mem_alloc(size_t size)
+{
+    if (pool_size == 0)
+    {
+        return NULL;
+    }
+
+    STAT_ADD(stat_request_histogram[size_class_of(size)], 1);
+
+#ifdef DEBUG_GUARD
+    if (!guard_budget_ok(size))
+    {
+        STAT_ADD(stat_failed_allocs, 1);
+        return NULL;
+    }
+    size += GUARD_REDZONE;      // Room for the rear canary; zero-byte requests
+                                // become real blocks so freeing them stays
+                                // well defined under the guard checks
+#endif
+
+    if (size == 0)
+    {
+        // Return the data pointer of any free block without allocating
+        for (int shard_index = 0; shard_index < NUM_SHARDS; shard_index++)
+        {
+            Shard *shard = &shards[shard_index];
+            pthread_mutex_lock(&shard->lock);
+            if (shard->free_mask)
+            {
+                void *result = shard->free_heads[__builtin_ctz(shard->free_mask)]->data;
+                pthread_mutex_unlock(&shard->lock);
+                return result;
+            }
+            pthread_mutex_unlock(&shard->lock);
+        }
+        return NULL;
+    }
+
+#ifdef LOCKFREE
+    // Fast path: exact-size hit on the class's lock-free stack
+    if (size <= MAGAZINE_MAX_SIZE)
+    {
+        Block *block = lf_pop(size);
+        if (block)
+        {
+            block->is_free = 0;
+            STAT_ADD(stat_alloc_count, 1);
+            STAT_ADD(stat_live_blocks, 1);
+            STAT_ADD(stat_live_bytes, block->size_of_block);
+#ifdef DEBUG_GUARD
+            guard_arm(block, __builtin_return_address(0));
+#endif
+            return block->data;
+        }
+    }
+#else
+    // Fast path: exact-size hit in the thread's own magazine
+    ThreadCache *cache = (size <= MAGAZINE_MAX_SIZE) ? get_cache() : NULL;
+    if (cache)
+    {
+        pthread_mutex_lock(&cache->lock);
+        if (cache->generation != pool_generation)
+        {
+            cache->count = 0;
+            cache->generation = pool_generation;
+        }
+        for (int i = 0; i < cache->count; i++)
+        {
+            if (cache->blocks[i]->size_of_block == size)
+            {
+                Block *block = cache->blocks[i];
+                cache->blocks[i] = cache->blocks[--cache->count];
+                pthread_mutex_unlock(&cache->lock);
+                block->is_free = 0;
+                STAT_ADD(stat_alloc_count, 1);
+                STAT_ADD(stat_live_blocks, 1);
+                STAT_ADD(stat_live_bytes, block->size_of_block);
+#ifdef DEBUG_GUARD
+                guard_arm(block, __builtin_return_address(0));
+#endif
+                return block->data;
+            }
+        }
+        pthread_mutex_unlock(&cache->lock);
+    }
+#endif
+
+    // Global path: scan the shards; on a miss, first pull parked blocks back
+    // in, then commit a new chunk, until neither can make progress
+    int reclaimed = 0;
+    int grow_failed = 0;
+    // Small objects are placed on cache-line boundaries so neighbouring
+    // allocations do not share a line, but only when the placement costs no
+    // capacity (zero_cost mode); anything else falls through to the plain
+    // carve, so tightly sized pools behave exactly as before
+    int want_align = (size >= CACHE_LINE_SIZE && size <= MAGAZINE_MAX_SIZE);
+    for (;;)
+    {
+        Block *found = NULL;
+        if (want_align)
+        {
+            found = alloc_aligned_from_shards(size, CACHE_LINE_SIZE, 1);
+        }
+        if (!found)
+        {
+            found = alloc_from_shards(size);
+        }
+        if (found)
+        {
+            STAT_ADD(stat_alloc_count, 1);
+            STAT_ADD(stat_live_blocks, 1);
+            STAT_ADD(stat_live_bytes, found->size_of_block);
+#ifdef DEBUG_GUARD
+            guard_arm(found, __builtin_return_address(0));
+#endif
+            return found->data;
+        }
+        if (!reclaimed)
+        {
+            reclaim_parked();
+            reclaimed = 1;
+            continue;
+        }
+        if (grow_failed || !grow_pool(size))
+        {
+            if (grow_failed)
+            {
+                STAT_ADD(stat_failed_allocs, 1);
+                return NULL;
+            }
+            grow_failed = 1;        // One more scavenge-and-scan round before giving up
+        }
+        reclaimed = 0;              // Another thread may consume the new chunk; scavenge again before growing more
+    }
+}
+
+
+void* mem_alloc_aligned(size_t size, size_t alignment)
+{
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+    {
+        return NULL;        // Alignment must be a power of two
+    }
+    if (alignment <= 1 || size == 0)
+    {
+        return mem_alloc(size);
+    }
+    if (pool_size == 0)
+    {
+        return NULL;
+    }
+
+    STAT_ADD(stat_request_histogram[size_class_of(size)], 1);
+
+#ifdef DEBUG_GUARD
+    if (!guard_budget_ok(size))
+    {
+        STAT_ADD(stat_failed_allocs, 1);
+        return NULL;
+    }
+    size += GUARD_REDZONE;      // Room for the rear canary, as in mem_alloc
+#endif
+
+    // Aligned blocks skip the magazines, whose parked blocks sit at whatever
+    // offset they were first carved at, and go straight to the global path:
+    // grab alignment slack along with the block, then trim it back off
+    int reclaimed = 0;
+    int grow_failed = 0;
+    for (;;)
+    {
+        Block *found = alloc_aligned_from_shards(size, alignment, 0);
+        if (found)
+        {
+            if (((size_t)found->data & (alignment - 1)) != 0)
+            {
+                free_block_global(found);       // Header memory ran out mid-split
+                return NULL;
+            }
+            STAT_ADD(stat_alloc_count, 1);
+            STAT_ADD(stat_live_blocks, 1);
+            STAT_ADD(stat_live_bytes, found->size_of_block);
+#ifdef DEBUG_GUARD
+            guard_arm(found, __builtin_return_address(0));
+#endif
+            return found->data;
+        }
+        if (!reclaimed)
+        {
+            reclaim_parked();
+            reclaimed = 1;
+            continue;
+        }
+        if (grow_failed || !grow_pool(size + alignment - 1))
+        {
+            if (grow_failed)
+            {
+                STAT_ADD(stat_failed_allocs, 1);
+                return NULL;
+            }
+            grow_failed = 1;        // One more scavenge-and-scan round before giving up
+        }
+        reclaimed = 0;              // Another thread may consume the new chunk; scavenge again before growing more
+    }
+}
+
+
+size_t mem_alloc_batch(size_t size, size_t n, void **out)
+{
+    if (pool_size == 0 || !out || size == 0 || n == 0)
+    {
+        return 0;
+    }
+
+#ifdef DEBUG_GUARD
+    size += GUARD_REDZONE;      // Every piece carries its own rear canary
+#endif
+
+    // Grab one contiguous extent and cut it into n equally sized blocks,
+    // so the free lists are touched once instead of once per element
+    void *extent = mem_alloc(size * n);
+    if (extent)
+    {
+        Shard *shard = shard_of_ptr((char*)extent);
+
+        pthread_mutex_lock(&shard->lock);
+        Block *current_block = map_lookup(shard, (const char*)extent);
+        Block *tail_next = current_block->next_block;
+#ifdef DEBUG_GUARD
+        size_t extent_size = current_block->size_of_block;
+#endif
+        size_t carved = 1;
+        current_block->size_of_block = size;
+
+        for (size_t i = 1; i < n; i++)
+        {
+            Block *piece = header_alloc(shard);
+            if (!piece)
+            {
+                // Out of header memory: fold the uncarved tail into the last piece
+                current_block->size_of_block = size * (n - i + 1);
+                break;
+            }
+            piece->size_of_block = size;
+            piece->is_free = 0;
+            piece->prev_block = current_block;
+            piece->data = (char*)extent + i * size;
+            current_block->next_block = piece;
+            map_insert(shard, piece->data, piece);
+            current_block = piece;
+            carved++;
+        }
+
+        current_block->next_block = tail_next;
+        if (tail_next)
+        {
+            tail_next->prev_block = current_block;
+        }
+#ifdef DEBUG_GUARD
+        // mem_alloc inflated the extent for its own canary; fold those bytes
+        // into the last piece so the physical chain stays contiguous
+        current_block->size_of_block = extent_size - (carved - 1) * size;
+#endif
+        pthread_mutex_unlock(&shard->lock);
+
+        STAT_ADD(stat_alloc_count, carved - 1);     // The extent itself was already counted
+        STAT_ADD(stat_live_blocks, carved - 1);
+
+        for (size_t i = 0; i < carved; i++)
+        {
+            out[i] = (char*)extent + i * size;
+        }
+#ifdef DEBUG_GUARD
+        for (size_t i = 0; i < carved; i++)
+        {
+            guard_arm(header_of(out[i]), __builtin_return_address(0));
+        }
+#endif
+        return carved;
+    }
+
+    // No contiguous extent available: fall back to one allocation per element
+    size_t count = 0;
+    while (count < n)
+    {
+        out[count] = mem_alloc(size);
+        if (!out[count])
+        {
+            break;
+        }
+        count++;
+    }
+    return count;
+}
+
+
+void mem_free(void* block)
+{
+    if (!block || pool_size == 0)
+    {
+        return;
+    }
+
+    // Locate the corresponding Block through its shard's map. The header of
+    // an allocated block is stable, so this read needs no lock.
+    Block *block_to_free = header_of(block);
+#ifdef DEBUG_GUARD
+    if (!block_to_free)
+    {
+        guard_fail("free of a pointer the pool does not own", block, NULL);
+    }
+    if (block_to_free->is_free)
+    {
+        guard_fail("double free", block, block_to_free);
+    }
+    guard_check(block_to_free, block);
+#endif
+    if (!block_to_free || block_to_free->is_free)
+    {
+        return;     // Block not found in our managed memory, or already free/parked
+    }
+
+    STAT_ADD(stat_free_count, 1);
+    STAT_SUB(stat_live_blocks, 1);
+    STAT_SUB(stat_live_bytes, block_to_free->size_of_block);
+
+#ifdef LOCKFREE
+    // Fast path: park small blocks on the class's lock-free stack
+    if (block_to_free->size_of_block <= MAGAZINE_MAX_SIZE)
+    {
+        block_to_free->is_free = 2;     // Parked, invisible to the coalescer until drained
+        lf_push(block_to_free);
+        return;
+    }
+#else
+    // Fast path: park small blocks in the thread's own magazine
+    if (block_to_free->size_of_block <= MAGAZINE_MAX_SIZE)
+    {
+        ThreadCache *cache = get_cache();
+        if (cache)
+        {
+            pthread_mutex_lock(&cache->lock);
+            if (cache->generation != pool_generation)
+            {
+                cache->count = 0;
+                cache->generation = pool_generation;
+            }
+            if (cache->count < MAGAZINE_CAPACITY)
+            {
+                block_to_free->is_free = 2;     // Parked in a magazine
+                cache->blocks[cache->count++] = block_to_free;
+                pthread_mutex_unlock(&cache->lock);
+                return;
+            }
+            flush_cache(cache);                 // Magazine full: return everything in one batch
+            block_to_free->is_free = 2;
+            cache->blocks[cache->count++] = block_to_free;
+            pthread_mutex_unlock(&cache->lock);
+            return;
+        }
+    }
+#endif
+
+    free_block_global(block_to_free);
+}
+
+
+void* mem_resize(void* block, size_t size)
+{
+    if (!block) {
+        return mem_alloc(size);
+    }
+
+    if (size == 0)
+    {
+        mem_free(block);
+        return NULL;
+    }
+
+    // Locate the corresponding Block through its shard's map
+    Block *old_block = header_of(block);
+
+    if (!old_block || old_block->is_free) {
+        return NULL;
+    }
+
+#ifdef DEBUG_GUARD
+    guard_check(old_block, block);
+    if (size + GUARD_REDZONE > old_block->size_of_block
+        && !guard_budget_ok(size + GUARD_REDZONE - old_block->size_of_block))
+    {
+        STAT_ADD(stat_failed_allocs, 1);
+        return NULL;
+    }
+    size += GUARD_REDZONE;      // Keep room for the rear canary through the resize
+#endif
+
+    if (old_block->size_of_block >= size) {
+        // Shrinking: split off the tail and return it to the pool so large
+        // extents are not pinned by blocks that no longer need the space
+        Shard *shard = shard_of_ptr((char*)block);
+        pthread_mutex_lock(&shard->lock);
+        if (old_block->size_of_block > size) {
+            Block *tail = header_alloc(shard);
+            if (tail) {
+                tail->size_of_block = old_block->size_of_block - size;
+                tail->is_free = 0;
+                tail->next_block = old_block->next_block;
+                tail->prev_block = old_block;
+                tail->data = (char*)block + size;
+                if (tail->next_block) {
+                    tail->next_block->prev_block = tail;
+                }
+                STAT_SUB(stat_live_bytes, tail->size_of_block);
+                old_block->size_of_block = size;
+                old_block->next_block = tail;
+                map_insert(shard, tail->data, tail);
+                free_into_shard(shard, tail);
+            }
+        }
+        pthread_mutex_unlock(&shard->lock);
+#ifdef DEBUG_GUARD
+        guard_arm(old_block, old_block->guard_owner);   // The canary moved with the new size
+#endif
+        return block;
+    }
+
+    // Growing: first try to absorb the physically next block if it is free,
+    // which extends the allocation in place and skips the copy entirely.
+    // The neighbor is shrunk from its front (re-keying it in the map at its
+    // new start) or consumed whole when the request needs all of it.
+    {
+        Shard *shard = shard_of_ptr((char*)block);
+        pthread_mutex_lock(&shard->lock);
+        Block *next = old_block->next_block;
+        if (next && next->is_free == 1
+            && old_block->size_of_block + next->size_of_block >= size)
+        {
+            size_t need = size - old_block->size_of_block;
+            size_t grown_from = old_block->size_of_block;
+            free_list_remove(shard, next);
+            if (next->size_of_block > need)
+            {
+                next->data += need;
+                next->size_of_block -= need;
+                map_insert(shard, next->data, next);    // The old entry goes stale on its own
+                free_list_insert(shard, next);
+                old_block->size_of_block = size;
+            }
+            else
+            {
+                // Exact fit: splice the neighbor out and take all of it
+                old_block->size_of_block += next->size_of_block;
+                old_block->next_block = next->next_block;
+                if (next->next_block)
+                {
+                    next->next_block->prev_block = old_block;
+                }
+                header_release(shard, next);    // Invalidate the absorbed header
+            }
+            STAT_ADD(stat_live_bytes, old_block->size_of_block - grown_from);
+            pthread_mutex_unlock(&shard->lock);
+#ifdef DEBUG_GUARD
+            guard_arm(old_block, old_block->guard_owner);   // The canary moved with the new size
+#endif
+            return block;
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+
+    size_t old_size = old_block->size_of_block;
+
+#ifdef DEBUG_GUARD
+    void* new_block = mem_alloc(size - GUARD_REDZONE);  // mem_alloc re-inflates
+#else
+    void* new_block = mem_alloc(size);
+#endif
+
+    if (new_block)
+    {
+        memcpy(new_block, block, old_size);
+        mem_free(block);
+    }
+
+    return new_block;
+}
+
+
+// A bump-pointer arena living inside one pool allocation: this struct sits
+// at the front and the payload follows it. Releasing or recycling the
+// arena never walks its allocations, so teardown is O(1) no matter how
+// many temporaries were carved from it.
+struct mem_arena {
+    char *base;     // First payload byte, 8-byte aligned
+    size_t size;    // Payload capacity in bytes
+    size_t used;    // Bytes handed out since the last reset
+};
+
+
+mem_arena *mem_arena_create(size_t size)
+{
+    // One pool allocation holds the struct, alignment slack and the payload
+    mem_arena *arena = (mem_arena*)mem_alloc(sizeof(mem_arena) + size + 7);
+    if (!arena) {
+        return NULL;
+    }
+
+    arena->base = (char*)(((size_t)(arena + 1) + 7) & ~(size_t)7);
+    arena->size = size;
+    arena->used = 0;
+    return arena;
+}
+
+
+void *mem_arena_alloc(mem_arena *arena, size_t size)
+{
+    if (!arena || size == 0) {
+        return NULL;
+    }
+
+    size = (size + 7) & ~(size_t)7;     // Keep every returned pointer 8-byte aligned
+    if (arena->used + size > arena->size) {
+        return NULL;                    // Arena full; the pool itself is not consulted
+    }
+
+    void *result = arena->base + arena->used;
+    arena->used += size;
+    return result;
+}
+
+
+void mem_arena_reset(mem_arena *arena)
+{
+    if (arena) {
+        arena->used = 0;    // Everything allocated so far is gone in O(1)
+    }
+}
+
+
+void mem_arena_destroy(mem_arena *arena)
+{
+    if (arena) {
+        mem_free(arena);    // Struct and payload are one pool block
+    }
+}
+
+
+#define MAX_EPOCH_THREADS 64    // Concurrently registered reader threads; slots are reused
+
+// One registered reader thread; epoch 0 means quiescent (outside any section)
+typedef struct EpochSlot {
+    unsigned long epoch;
+    int claimed;
+} EpochSlot;
+
+// A block waiting out its grace period before returning to the free lists
+typedef struct DeferredBlock {
+    void *ptr;
+    unsigned long epoch;        // Global epoch when the block was queued
+    struct DeferredBlock *next;
+} DeferredBlock;
+
+static EpochSlot epoch_slots[MAX_EPOCH_THREADS];
+static __thread EpochSlot *my_epoch_slot = NULL;
+static unsigned long global_epoch = 2;      // Starts above the reclaim horizon
+static int unregistered_readers = 0;        // Readers that found the slot table full
+static DeferredBlock *deferred_head = NULL; // Blocks waiting for their grace period
+static pthread_mutex_t epoch_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t epoch_key;
+static pthread_once_t epoch_key_once = PTHREAD_ONCE_INIT;
+
+
+// Returns a thread's slot to the table when the thread exits
+static void epoch_slot_release(void *arg)
+{
+    EpochSlot *slot = (EpochSlot *)arg;
+    __atomic_store_n(&slot->epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&slot->claimed, 0, __ATOMIC_RELEASE);
+}
+
+
+static void epoch_key_create(void)
+{
+    pthread_key_create(&epoch_key, epoch_slot_release);
+}
+
+
+// Claims a per-thread reader slot on a thread's first mem_epoch_enter
+static EpochSlot *epoch_slot_claim(void)
+{
+    pthread_once(&epoch_key_once, epoch_key_create);
+    pthread_mutex_lock(&epoch_lock);
+    for (int slot_index = 0; slot_index < MAX_EPOCH_THREADS; slot_index++) {
+        if (!epoch_slots[slot_index].claimed) {
+            epoch_slots[slot_index].claimed = 1;
+            epoch_slots[slot_index].epoch = 0;
+            my_epoch_slot = &epoch_slots[slot_index];
+            break;
+        }
+    }
+    if (!my_epoch_slot) {
+        // Table full: the reader stays safe by pausing all reclamation instead
+        unregistered_readers++;
+    }
+    pthread_mutex_unlock(&epoch_lock);
+    if (my_epoch_slot) {
+        pthread_setspecific(epoch_key, my_epoch_slot);
+    }
+    return my_epoch_slot;
+}
+
+
+void mem_epoch_enter(void)
+{
+    EpochSlot *slot = my_epoch_slot;
+    if (!slot) {
+        slot = epoch_slot_claim();
+        if (!slot) {
+            return;     // Counted as an unregistered reader; reclamation stalls
+        }
+    }
+
+    // Publish the epoch this section observes before any reads inside it
+    unsigned long current = __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&slot->epoch, current, __ATOMIC_SEQ_CST);
+}
+
+
+void mem_epoch_exit(void)
+{
+    if (my_epoch_slot) {
+        __atomic_store_n(&my_epoch_slot->epoch, 0, __ATOMIC_RELEASE);
+        return;
+    }
+
+    // An unregistered reader leaving re-enables reclamation
+    pthread_mutex_lock(&epoch_lock);
+    if (unregistered_readers > 0) {
+        unregistered_readers--;
+    }
+    pthread_mutex_unlock(&epoch_lock);
+}
+
+
+size_t mem_epoch_reclaim(void)
+{
+    size_t reclaimed = 0;
+    pthread_mutex_lock(&epoch_lock);
+
+    // The epoch may advance once every registered reader inside a section
+    // has already observed the current value
+    unsigned long current = __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE);
+    int can_advance = (unregistered_readers == 0);
+    for (int slot_index = 0; can_advance && slot_index < MAX_EPOCH_THREADS; slot_index++) {
+        unsigned long seen = __atomic_load_n(&epoch_slots[slot_index].epoch, __ATOMIC_ACQUIRE);
+        if (seen != 0 && seen != current) {
+            can_advance = 0;
+        }
+    }
+    if (can_advance) {
+        current++;
+        __atomic_store_n(&global_epoch, current, __ATOMIC_RELEASE);
+    }
+
+    // Two full advances past its queueing epoch prove no reader that could
+    // have held the block remains inside a section
+    DeferredBlock **link = &deferred_head;
+    while (*link) {
+        DeferredBlock *entry = *link;
+        if (entry->epoch + 2 <= current) {
+            *link = entry->next;
+            mem_free(entry->ptr);
+            free(entry);
+            reclaimed++;
+        } else {
+            link = &entry->next;
+        }
+    }
+
+    pthread_mutex_unlock(&epoch_lock);
+    return reclaimed;
+}
+
+
+void mem_free_deferred(void *block)
+{
+    if (!block) {
+        return;
+    }
+
+    DeferredBlock *entry = malloc(sizeof(DeferredBlock));
+    if (!entry) {
+        mem_free(block);    // Out of metadata memory: forfeit the grace period
+        return;
+    }
+
+    entry->ptr = block;
+    entry->epoch = __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE);
+    pthread_mutex_lock(&epoch_lock);
+    entry->next = deferred_head;
+    deferred_head = entry;
+    pthread_mutex_unlock(&epoch_lock);
+
+    mem_epoch_reclaim();    // Piggyback an advance attempt on every deferral
+}
+
+
+// A handle is just the block header, which stays put while mem_compact
+// moves the payload it points at
+mem_handle mem_handle_of(void *block)
+{
+    return header_of(block);
+}
+
+
+void *mem_handle_ptr(mem_handle handle)
+{
+    return handle ? handle->data : NULL;
+}
+
+
+// Slides every live payload in a chunk down over the free gaps below it
+// and rebuilds the physical chain with one merged free block at the tail.
+// Re-inserting a moved block under its new address is all the map needs:
+// the old entry's key no longer matches header->data, which is exactly the
+// staleness condition map_insert and header_of already reject.
+size_t mem_compact(void)
+{
+    reclaim_parked();       // Parked blocks would otherwise pin their extents
+
+    size_t largest = 0;
+    int chunk_count = __atomic_load_n(&num_chunks, __ATOMIC_ACQUIRE);
+    for (int chunk_index = 0; chunk_index < chunk_count; chunk_index++)
+    {
+        PoolChunk *chunk = &chunks[chunk_index];
+        Shard *shard = &shards[chunk->shard_index];
+        pthread_mutex_lock(&shard->lock);
+
+        // The block at the chunk start always has the payload base as its
+        // address, so the physical chain is reachable through the map
+        Block *current_block = map_lookup(shard, chunk->payload);
+        char *write_ptr = chunk->payload;
+        Block *last_kept = NULL;
+        while (current_block)
+        {
+            Block *next_block = current_block->next_block;
+            if (current_block->is_free == 1)
+            {
+                // Absorb the gap; releasing the header makes its map entry stale
+                free_list_remove(shard, current_block);
+                header_release(shard, current_block);
+            }
+            else
+            {
+                if (current_block->data != write_ptr)
+                {
+                    memmove(write_ptr, current_block->data, current_block->size_of_block);
+                    map_insert(shard, write_ptr, current_block);
+                    current_block->data = write_ptr;
+                }
+                current_block->prev_block = last_kept;
+                if (last_kept)
+                {
+                    last_kept->next_block = current_block;
+                }
+                write_ptr += current_block->size_of_block;
+                last_kept = current_block;
+            }
+            current_block = next_block;
+        }
+        if (last_kept)
+        {
+            last_kept->next_block = NULL;
+        }
+
+        size_t tail_size = (size_t)(chunk->payload + chunk->size - write_ptr);
+        if (tail_size > 0)
+        {
+            // A trailing gap means at least one free header was released
+            // above, so header_alloc is served from the spares and cannot fail
+            Block *tail_block = header_alloc(shard);
+            tail_block->size_of_block = tail_size;
+            tail_block->is_free = 1;
+            tail_block->data = write_ptr;
+            tail_block->prev_block = last_kept;
+            tail_block->next_block = NULL;
+            if (last_kept)
+            {
+                last_kept->next_block = tail_block;
+            }
+            map_insert(shard, tail_block->data, tail_block);
+            free_list_insert(shard, tail_block);
+            if (tail_size > largest)
+            {
+                largest = tail_size;
+            }
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+    return largest;
+}
+
+
+void mem_stats(mem_stats_t *out)
+{
+    if (!out)
+    {
+        return;
+    }
+    memset(out, 0, sizeof(*out));
+
+    out->capacity = pool_size;
+    out->committed_bytes = __atomic_load_n(&committed_size, __ATOMIC_RELAXED);
+    out->live_bytes = __atomic_load_n(&stat_live_bytes, __ATOMIC_RELAXED);
+    out->live_blocks = __atomic_load_n(&stat_live_blocks, __ATOMIC_RELAXED);
+    out->alloc_count = __atomic_load_n(&stat_alloc_count, __ATOMIC_RELAXED);
+    out->free_count = __atomic_load_n(&stat_free_count, __ATOMIC_RELAXED);
+    out->failed_allocs = __atomic_load_n(&stat_failed_allocs, __ATOMIC_RELAXED);
+    for (int class_index = 0; class_index < MEM_STATS_SIZE_BUCKETS; class_index++)
+    {
+        out->request_histogram[class_index] = __atomic_load_n(&stat_request_histogram[class_index], __ATOMIC_RELAXED);
+    }
+    out->free_bytes = out->committed_bytes > out->live_bytes ? out->committed_bytes - out->live_bytes : 0;
+
+    // The largest free extent requires walking the free lists; stats are
+    // scraped far less often than blocks are allocated, so the shard locks
+    // are acceptable here
+    for (int shard_index = 0; shard_index < NUM_SHARDS; shard_index++)
+    {
+        Shard *shard = &shards[shard_index];
+        pthread_mutex_lock(&shard->lock);
+        for (int class_index = 0; class_index < NUM_SIZE_CLASSES; class_index++)
+        {
+            for (Block *block = shard->free_heads[class_index]; block; block = block->next_free)
+            {
+                if (block->size_of_block > out->largest_free_block)
+                {
+                    out->largest_free_block = block->size_of_block;
+                }
+            }
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+
+    out->fragmentation = out->free_bytes > 0
+                             ? 1.0 - (double)out->largest_free_block / (double)out->free_bytes
+                             : 0.0;
+}
+
+
+void mem_deinit()
+{
+    // Deferred blocks must not outlive the pool they point into; by the
+    // time the pool is torn down no readers can remain, so free them now
+    pthread_mutex_lock(&epoch_lock);
+    while (deferred_head)
+    {
+        DeferredBlock *entry = deferred_head;
+        deferred_head = entry->next;
+        mem_free(entry->ptr);
+        free(entry);
+    }
+    pthread_mutex_unlock(&epoch_lock);
+
+#ifdef DEBUG_GUARD
+    // Staging leak report: anything still allocated at teardown is listed
+    // together with the callsite that allocated it
+    reclaim_parked();
+    size_t leaked_blocks = 0;
+    size_t leaked_bytes = 0;
+    int leak_chunks = __atomic_load_n(&num_chunks, __ATOMIC_ACQUIRE);
+    for (int chunk_index = 0; chunk_index < leak_chunks; chunk_index++)
+    {
+        Shard *shard = &shards[chunks[chunk_index].shard_index];
+        for (Block *block = map_lookup(shard, chunks[chunk_index].payload); block; block = block->next_block)
+        {
+            if (block->is_free == 0)
+            {
+                leaked_blocks++;
+                leaked_bytes += block->size_of_block - GUARD_REDZONE;
+                if (leaked_blocks <= 32)    // Cap the listing; the summary still counts everything
+                {
+                    fprintf(stderr, "DEBUG_GUARD: leaked block %p of %zu bytes allocated from %p\n",
+                            (void*)block->data, block->size_of_block - GUARD_REDZONE, block->guard_owner);
+                }
+            }
+        }
+    }
+    if (leaked_blocks > 0)
+    {
+        fprintf(stderr, "DEBUG_GUARD: %zu leaked block(s), %zu bytes total\n", leaked_blocks, leaked_bytes);
+    }
+#endif
+
+    if (pool_fd >= 0)
+    {
+        mem_snapshot();     // Persist the allocator state so the next start is warm
+    }
+
+#ifndef LOCKFREE
+    pool_generation++;          // Blocks still parked in thread caches belong to the dead pool
+#else
+    for (int class_index = 0; class_index < NUM_SIZE_CLASSES; class_index++)
+    {
+        FreeStackHead empty_head = { NULL, 0 };
+        atomic_store(&lf_stacks[class_index], empty_head);      // Parked blocks belong to the dead pool
+    }
+#endif
+
+    for (int shard_index = 0; shard_index < NUM_SHARDS; shard_index++)
+    {
+        Shard *shard = &shards[shard_index];
+        pthread_mutex_destroy(&shard->lock);
+        while (shard->slabs)
+        {
+            HeaderSlab *next = shard->slabs->next;
+            free(shard->slabs);
+            shard->slabs = next;
+        }
+        while (shard->map)      // Frees the live map and every retired one behind it
+        {
+            HeaderMap *next = shard->map->retired_next;
+            free(shard->map);
+            shard->map = next;
+        }
+        shard->spare_headers = NULL;
+        shard->slab_used = 0;
+        shard->map_used = 0;
+    }
+
+    for (int chunk_index = 0; chunk_index < num_chunks; chunk_index++)
+    {
+        chunk_release(&chunks[chunk_index]);
+    }
+    num_chunks = 0;
+    committed_size = 0;
+    pool_size = 0;
+
+    if (pool_fd >= 0)
+    {
+        munmap(pool_file_base, pool_file_map_len);
+        close(pool_fd);
+        pool_fd = -1;
+        pool_file_base = NULL;
+        pool_file_map_len = 0;
+    }
 }
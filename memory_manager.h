@@ -10,8 +10,14 @@
 typedef struct Block {
     size_t size_of_block;           // Size of the block
     int is_free;                    // Block free status: 1 if free, 0 if allocated
-    struct Block* next_block;       // Pointer to the next block
+    struct Block* next_block;       // Physically next block (address order)
+    struct Block* prev_block;       // Physically previous block (address order)
+    struct Block* next_free;        // Next block in the same size-class free list
+    struct Block* prev_free;        // Previous block in the same size-class free list
     char* data;                    // Pointer to the data in the block
+#ifdef DEBUG_GUARD
+    void* guard_owner;              // Return address of the allocating call (guarded builds only)
+#endif
 } Block;
 
 // Helps C++ compilers to handle C header files
@@ -22,13 +28,175 @@ extern "C"
 
     /**
      * Initializes the memory manager with a specified size of memory pool.
-     * The memory pool could be any data structure, for instance, a large array
-     * or a similar contiguous block of memory.
+     * The size acts as a capacity: small pools are committed up front, while
+     * large pools start with one small chunk and commit further chunks on
+     * demand (doubling each time) as allocations need them.
      *
-     * @param size The size of the memory pool to initialize.
+     * @param size The capacity of the memory pool to initialize.
      */
     void mem_init(size_t size);
 
+    /**
+     * Placement options for the pool memory, used by mem_init_ex. All fields
+     * zero (or a NULL options pointer) selects the plain malloc-backed pool.
+     */
+    typedef struct mem_init_options
+    {
+        int use_mmap;       /* Obtain pool chunks with mmap instead of malloc */
+        int use_huge_pages; /* Back chunks with explicit huge pages (MAP_HUGETLB) */
+        int use_thp;        /* Ask for transparent huge pages (madvise) */
+        int numa_node;      /* NUMA node to bind chunks to, or -1 for no binding */
+    } mem_init_options;
+
+    /**
+     * Initializes the memory manager like mem_init, but with control over how
+     * the pool memory is obtained and placed. Huge pages and NUMA binding are
+     * applied per chunk and silently fall back to the plain path when the
+     * kernel cannot honor them, so initialization never fails for placement
+     * reasons alone.
+     *
+     * @param size The capacity of the memory pool to initialize.
+     * @param options Placement options, or NULL for the defaults.
+     */
+    void mem_init_ex(size_t size, const mem_init_options *options);
+
+    /**
+     * Initializes the memory manager on top of a memory-mapped file, so the
+     * pool contents survive process restarts. If the file already holds a
+     * snapshotted pool of the same size, every prior allocation is live again
+     * immediately: the payload is mapped back at its recorded address and the
+     * allocator state is rebuilt from the block table in one pass. Otherwise
+     * the file is (re)created as a fresh pool. File-backed pools are
+     * committed whole and never grow beyond the given size.
+     *
+     * @param path Path of the pool file to create or reopen.
+     * @param size The capacity of the memory pool.
+     * @return 1 if a previous pool was restored, 0 for a fresh pool, -1 on error.
+     */
+    int mem_init_file(const char *path, size_t size);
+
+    /**
+     * Persists the current allocator state of a file-backed pool: flushes the
+     * payload and writes the block table that mem_init_file restores from.
+     * Called automatically by mem_deinit; call it earlier for crash safety.
+     * The pool should be quiescent, since blocks parked in thread caches are
+     * pulled back before the table is written.
+     *
+     * @return 0 on success, -1 if the pool is not file-backed or writing fails.
+     */
+    int mem_snapshot(void);
+
+    /**
+     * A bump-pointer arena carved out of the memory pool. Allocations from
+     * an arena are individually free of bookkeeping and the whole arena is
+     * released or recycled in O(1), which suits phase-based workloads that
+     * build up many temporaries and drop them all at once. An arena is not
+     * internally synchronized; use one arena per thread or phase.
+     */
+    typedef struct mem_arena mem_arena;
+
+    /**
+     * Carves an arena of the given capacity out of the memory pool.
+     *
+     * @param size The number of bytes the arena can hand out.
+     * @return The new arena, or NULL if the pool cannot satisfy it.
+     */
+    mem_arena *mem_arena_create(size_t size);
+
+    /**
+     * Allocates from the arena by bumping its position pointer. Allocations
+     * are aligned to 8 bytes and cannot be freed individually; they live
+     * until the arena is reset or destroyed.
+     *
+     * @param arena The arena to allocate from.
+     * @param size The size of the memory block to allocate.
+     * @return A pointer into the arena, or NULL when the arena is full.
+     */
+    void *mem_arena_alloc(mem_arena *arena, size_t size);
+
+    /**
+     * Releases everything allocated from the arena in O(1) by rewinding the
+     * position pointer. The arena's memory stays reserved for reuse.
+     *
+     * @param arena The arena to reset.
+     */
+    void mem_arena_reset(mem_arena *arena);
+
+    /**
+     * Returns the arena and everything allocated from it to the pool.
+     *
+     * @param arena The arena to destroy.
+     */
+    void mem_arena_destroy(mem_arena *arena);
+
+    /**
+     * Marks the calling thread as inside a read-side critical section of the
+     * epoch-based reclamation scheme. Blocks passed to mem_free_deferred are
+     * not recycled while any thread that could still hold a pointer to them
+     * remains inside its section, so readers can traverse shared structures
+     * with no locks at all. Sections must not nest.
+     */
+    void mem_epoch_enter(void);
+
+    /**
+     * Leaves the read-side critical section opened by mem_epoch_enter.
+     */
+    void mem_epoch_exit(void);
+
+    /**
+     * Defers the release of a block until every thread currently inside a
+     * read-side section has left it. The block is unlinked by the caller
+     * first, queued with the current epoch, and handed to mem_free once two
+     * epoch advances prove no reader can still reach it. Outside of any
+     * concurrent readers this behaves like a slightly delayed mem_free.
+     *
+     * @param block A pointer to the memory block to free once safe.
+     */
+    void mem_free_deferred(void *block);
+
+    /**
+     * Tries to advance the global epoch and release every deferred block
+     * that has become unreachable. Called internally by mem_free_deferred;
+     * call it directly to drain the queue after readers have finished.
+     *
+     * @return The number of blocks handed back to the pool by this call.
+     */
+    size_t mem_epoch_reclaim(void);
+
+/* Number of power-of-two request-size buckets reported by mem_stats */
+#define MEM_STATS_SIZE_BUCKETS 32
+
+    /**
+     * Point-in-time view of the allocator, filled in by mem_stats. The
+     * counters are maintained with relaxed atomics on the allocation hot
+     * paths, so concurrent readings are cheap but only approximately
+     * consistent with each other.
+     */
+    typedef struct mem_stats_t
+    {
+        size_t capacity;            /* Pool capacity given to mem_init */
+        size_t committed_bytes;     /* Bytes committed in chunks so far */
+        size_t live_bytes;          /* Payload bytes currently allocated */
+        size_t free_bytes;          /* Committed bytes not currently allocated */
+        size_t live_blocks;         /* Blocks currently allocated */
+        size_t largest_free_block;  /* Largest single free extent, in bytes */
+        size_t alloc_count;         /* Successful allocations since mem_init */
+        size_t free_count;          /* Frees since mem_init */
+        size_t failed_allocs;       /* Allocations that returned NULL */
+        size_t request_histogram[MEM_STATS_SIZE_BUCKETS]; /* Requests per power-of-two size bucket */
+        double fragmentation;       /* 1 - largest_free_block / free_bytes; 0 when nothing is free */
+    } mem_stats_t;
+
+    /**
+     * Fills out with the allocator's current statistics. Counter fields cost
+     * one relaxed atomic on the hot paths; the largest free extent is found
+     * by scanning the free lists under the shard locks, so call this at
+     * scrape frequency rather than per allocation.
+     *
+     * @param out The statistics structure to fill.
+     */
+    void mem_stats(mem_stats_t *out);
+
     /**
      * Allocates a block of memory of the specified size. This function finds a
      * suitable block in the pool, marks it as allocated, and returns a pointer
@@ -39,6 +207,32 @@ extern "C"
      */
     void *mem_alloc(size_t size);
 
+    /**
+     * Allocates a block whose address is a multiple of the given alignment,
+     * which must be a power of two. The alignment slack is trimmed off and
+     * returned to the pool, so an aligned block costs its size, not its
+     * size plus the alignment. Small allocations from mem_alloc already
+     * land on cache-line boundaries when the pool has room; use this for
+     * stronger guarantees, such as SIMD vector widths or page alignment.
+     *
+     * @param size The size of the memory block to allocate.
+     * @param alignment The required address alignment, a power of two.
+     * @return A pointer to the aligned block, or NULL if allocation fails.
+     */
+    void *mem_alloc_aligned(size_t size, size_t alignment);
+
+    /**
+     * Allocates n blocks of the same size in one batch. The blocks are carved
+     * out of one contiguous extent under a single lock acquisition when
+     * possible, and each block can still be freed individually with mem_free.
+     *
+     * @param size The size of each memory block to allocate.
+     * @param n The number of blocks to allocate.
+     * @param out Array receiving the allocated block pointers.
+     * @return The number of blocks successfully allocated, from 0 to n.
+     */
+    size_t mem_alloc_batch(size_t size, size_t n, void **out);
+
     /**
      * Frees the specified block of memory. This function marks the block as free
      * within the memory manager's data structure.
@@ -57,6 +251,45 @@ extern "C"
      */
     void *mem_resize(void *block, size_t size);
 
+    /**
+     * Stable handle to an allocated block, for callers that opt into
+     * compaction. A handle keeps identifying its block across mem_compact,
+     * which may move payloads around; such callers hold handles instead of
+     * caching raw pointers and re-fetch the payload address with
+     * mem_handle_ptr after each pass.
+     */
+    typedef Block *mem_handle;
+
+    /**
+     * Returns the handle of an allocated block.
+     *
+     * @param block A pointer returned by mem_alloc.
+     * @return The block's handle, or NULL if no managed block starts there.
+     */
+    mem_handle mem_handle_of(void *block);
+
+    /**
+     * Returns the current payload address of the block behind a handle.
+     * Call it again after mem_compact, which may have moved the payload.
+     *
+     * @param handle A handle obtained from mem_handle_of.
+     * @return The block's payload address, or NULL for a NULL handle.
+     */
+    void *mem_handle_ptr(mem_handle handle);
+
+    /**
+     * Defragments the pool by sliding live payloads toward the start of
+     * each chunk and merging the recovered space into one free extent per
+     * chunk, so a fragmented long-running pool regains its large
+     * allocations without a restart. Raw pointers into moved blocks are
+     * invalidated; callers opting into compaction hold mem_handles and
+     * re-fetch addresses afterwards. The pool must be quiescent while the
+     * pass runs: no other thread may be touching block payloads.
+     *
+     * @return The size in bytes of the largest free extent after the pass.
+     */
+    size_t mem_compact(void);
+
     /**
      * Frees up the entire memory pool that was initially allocated by mem_init.
      * This function should be called to clean up the memory manager resources before
@@ -5,6 +5,8 @@
 #include <time.h>
 #include <stddef.h>
 #include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "common_defs.h"
 #include "gitdata.h"
 
@@ -644,7 +646,536 @@ void test_list_edge_cases()
     printf_green("[PASS].\n");
 }
 
+void test_list_insert_bulk()
+{
+    printf_yellow("  Testing list_insert_bulk ---> ");
+    Node *head = NULL;
+    list_init(&head, 4096);
+
+    uint16_t values[2048];
+    for (int i = 0; i < 2048; i++)
+        values[i] = i;
+
+    list_insert(&head, 9999); // Bulk append must preserve existing nodes
+    list_insert_bulk(&head, values, 2048);
+
+    my_assert(list_count_nodes(&head) == 2049);
+    Node *node = head;
+    my_assert(node->data == 9999);
+    node = node->next;
+    for (int i = 0; i < 2048; i++)
+    {
+        my_assert(node->data == values[i]);
+        node = node->next;
+    }
+    my_assert(node == NULL);
+
+    list_cleanup(&head);
+    my_assert(list_count_nodes(&head) == 0);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+void test_list_handle()
+{
+    printf_yellow("  Testing list handle (tail pointer and cached count) ---> ");
+    List list;
+    list_handle_init(&list, 8192);
+
+    for (int i = 0; i < 4096; i++)
+        list_handle_insert(&list, i); // O(1) appends through the tail pointer
+
+    my_assert(list_handle_count(&list) == 4096);
+    my_assert(list_count_nodes(&list.head) == 4096); // Cached count matches a real traversal
+    my_assert(list.tail != NULL && list.tail->data == 4095);
+
+    list_handle_delete(&list, 0);    // Delete the head
+    list_handle_delete(&list, 4095); // Delete the tail
+    list_handle_delete(&list, 2000); // Delete in the middle
+    my_assert(list_handle_count(&list) == 4093);
+    my_assert(list.head->data == 1);
+    my_assert(list.tail->data == 4094);
+
+    list_handle_insert(&list, 7); // Appending after a tail delete must still work
+    my_assert(list.tail->data == 7);
+    my_assert(list_handle_search(&list, 7) != NULL);
+    my_assert(list_handle_search(&list, 2000) == NULL);
+
+    list_handle_cleanup(&list);
+    my_assert(list_handle_count(&list) == 0);
+    my_assert(list.head == NULL && list.tail == NULL);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+void test_chunk_list()
+{
+    printf_yellow("  Testing unrolled chunk list ---> ");
+    ChunkList list;
+    chunk_list_init(&list, 10000);
+
+    for (int i = 0; i < 10000; i++)
+        chunk_list_insert(&list, i % 5000); // Every value appears twice
+
+    my_assert(chunk_list_count(&list) == 10000);
+    my_assert(chunk_list_search(&list, 0) != NULL);
+    my_assert(chunk_list_search(&list, 4999) != NULL);
+    my_assert(chunk_list_search(&list, 5000) == NULL);
+
+    chunk_list_delete(&list, 123); // First occurrence goes, the duplicate stays
+    my_assert(chunk_list_count(&list) == 9999);
+    my_assert(chunk_list_search(&list, 123) != NULL);
+    chunk_list_delete(&list, 123);
+    my_assert(chunk_list_search(&list, 123) == NULL);
+
+    // Deleting a whole chunk's worth of values must unlink the empty chunk
+    for (int i = 0; i < CHUNK_CAPACITY; i++)
+        chunk_list_delete(&list, i);
+    my_assert(chunk_list_count(&list) == 9998 - CHUNK_CAPACITY);
+    my_assert(list.head != NULL);
+
+    chunk_list_cleanup(&list);
+    my_assert(chunk_list_count(&list) == 0);
+    my_assert(list.head == NULL && list.tail == NULL);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+void test_list_search_fast()
+{
+    printf_yellow("  Testing list_search_fast (SIMD) against scalar search ---> ");
+    ChunkList list;
+    chunk_list_init(&list, 20000);
+
+    for (int i = 0; i < 20000; i++)
+        chunk_list_insert(&list, (uint16_t)(rand() % 30000));
+
+    // Both searches must agree on hits, misses and the exact match position
+    for (int i = 0; i < 2000; i++)
+    {
+        uint16_t key = (uint16_t)(rand() % 40000);
+        my_assert(list_search_fast(&list, key) == chunk_list_search(&list, key));
+    }
+
+    chunk_list_cleanup(&list);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
 // Main function to run all tests
+void test_list_sorted()
+{
+    printf_yellow("  Testing sorted list with skip-list index ---> ");
+    SortedList list;
+    sorted_list_init(&list, 10000);
+
+    // Insert shuffled keys; the list must come out in ascending order
+    for (int i = 0; i < 10000; i++)
+        list_insert_sorted(&list, (uint16_t)(rand() % 30000));
+
+    int count = 0;
+    uint16_t prev = 0;
+    for (SortedNode *node = list.head->forward[0]; node; node = node->forward[0])
+    {
+        my_assert(node->data >= prev);
+        prev = node->data;
+        count++;
+    }
+    my_assert(count == 10000);
+    my_assert(sorted_list_count(&list) == 10000);
+
+    // The largest stored key must be found; a key above the range must not
+    my_assert(list_search_sorted(&list, prev) != NULL);
+    my_assert(list_search_sorted(&list, 40000) == NULL);
+
+    // Duplicates stay searchable until the last copy is deleted
+    list_insert_sorted(&list, 30001);
+    list_insert_sorted(&list, 30001);
+    my_assert(sorted_list_count(&list) == 10002);
+    sorted_list_delete(&list, 30001);
+    my_assert(list_search_sorted(&list, 30001) != NULL);
+    sorted_list_delete(&list, 30001);
+    my_assert(list_search_sorted(&list, 30001) == NULL);
+    my_assert(sorted_list_count(&list) == 10000);
+
+    // Deleting a missing key must leave the list untouched
+    sorted_list_delete(&list, 40000);
+    my_assert(sorted_list_count(&list) == 10000);
+
+    sorted_list_cleanup(&list);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+typedef struct
+{
+    CList *list;
+    uint16_t start_value;
+    int num_nodes;
+} clist_thread_data_t;
+
+void *thread_clist_insert(void *arg)
+{
+    clist_thread_data_t *data = (clist_thread_data_t *)arg;
+    for (int i = 0; i < data->num_nodes; i++)
+    {
+        clist_insert(data->list, data->start_value + i);
+    }
+    return NULL;
+}
+
+void *thread_clist_delete(void *arg)
+{
+    clist_thread_data_t *data = (clist_thread_data_t *)arg;
+    for (int i = 0; i < data->num_nodes; i++)
+    {
+        clist_delete(data->list, data->start_value + i);
+    }
+    return NULL;
+}
+
+void *thread_clist_search(void *arg)
+{
+    clist_thread_data_t *data = (clist_thread_data_t *)arg;
+    for (int i = 0; i < data->num_nodes; i++)
+    {
+        clist_search(data->list, data->start_value + i);    // Result may race with deleters
+    }
+    return NULL;
+}
+
+void test_clist()
+{
+    printf_yellow("  Testing concurrent list with hand-over-hand locking ---> ");
+    const int num_threads = 4;
+    const int nodes_per_thread = 500;
+
+    CList list;
+    clist_init(&list, num_threads * nodes_per_thread);
+
+    // Concurrent inserts from all threads; every node must survive
+    pthread_t threads[num_threads];
+    clist_thread_data_t thread_data[num_threads];
+    for (int i = 0; i < num_threads; i++)
+    {
+        thread_data[i].list = &list;
+        thread_data[i].start_value = (uint16_t)(i * nodes_per_thread);
+        thread_data[i].num_nodes = nodes_per_thread;
+        pthread_create(&threads[i], NULL, thread_clist_insert, &thread_data[i]);
+    }
+    for (int i = 0; i < num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    my_assert(clist_count(&list) == num_threads * nodes_per_thread);
+
+    // Every inserted value must be findable after the writers are done
+    for (int i = 0; i < num_threads * nodes_per_thread; i++)
+    {
+        my_assert(clist_search(&list, (uint16_t)i) != NULL);
+    }
+
+    // Deleters race with searchers; each deleter removes exactly its own values
+    pthread_t searchers[num_threads];
+    for (int i = 0; i < num_threads; i++)
+    {
+        pthread_create(&threads[i], NULL, thread_clist_delete, &thread_data[i]);
+        pthread_create(&searchers[i], NULL, thread_clist_search, &thread_data[i]);
+    }
+    for (int i = 0; i < num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+        pthread_join(searchers[i], NULL);
+    }
+    my_assert(clist_count(&list) == 0);
+    my_assert(clist_search(&list, 0) == NULL);
+
+    clist_cleanup(&list);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+void test_arena_list()
+{
+    printf_yellow("  Testing arena-backed list with O(1) teardown ---> ");
+    mem_init(1024 * 1024);
+
+    mem_arena *arena = mem_arena_create(512 * 1024);
+    my_assert(arena != NULL);
+
+    ArenaList list;
+    list_init_in_arena(&list, arena);
+
+    // Several build-and-drop phases reuse the same arena memory
+    for (int phase = 0; phase < 3; phase++)
+    {
+        for (int i = 0; i < 5000; i++)
+        {
+            arena_list_insert(&list, (uint16_t)i);
+        }
+        my_assert(arena_list_count(&list) == 5000);
+        my_assert(arena_list_search(&list, 4999) != NULL);
+        my_assert(arena_list_search(&list, 5001) == NULL);
+
+        // Delete unlinks without freeing; the arena reclaims it at reset
+        arena_list_delete(&list, 0);
+        my_assert(arena_list_count(&list) == 4999);
+        my_assert(arena_list_search(&list, 0) == NULL);
+
+        arena_list_reset(&list);    // Whole phase torn down in O(1)
+        my_assert(arena_list_count(&list) == 0);
+        my_assert(list.head == NULL);
+    }
+
+    mem_arena_destroy(arena);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+typedef struct
+{
+    Node **head;
+    int iterations;
+    int *stop;
+} deferred_reader_data_t;
+
+void *thread_deferred_reader(void *arg)
+{
+    deferred_reader_data_t *data = (deferred_reader_data_t *)arg;
+
+    // Readers traverse with no locks; the epoch section keeps any node they
+    // can reach alive until they leave it
+    while (!__atomic_load_n(data->stop, __ATOMIC_ACQUIRE))
+    {
+        mem_epoch_enter();
+        volatile int sum = 0;
+        for (Node *node = *data->head; node; node = node->next)
+        {
+            sum += node->data;
+        }
+        mem_epoch_exit();
+    }
+    return NULL;
+}
+
+void test_list_deferred()
+{
+    printf_yellow("  Testing list_delete_deferred under lock-free readers ---> ");
+    const int num_nodes = 2000;
+    const int num_readers = 3;
+
+    Node *head = NULL;
+    list_init(&head, num_nodes * 2);
+    for (int i = 0; i < num_nodes; i++)
+    {
+        list_insert(&head, (uint16_t)i);
+    }
+
+    // Readers hammer the list while the writer deletes every node deferred
+    int stop = 0;
+    pthread_t readers[num_readers];
+    deferred_reader_data_t reader_data = {.head = &head, .stop = &stop};
+    for (int i = 0; i < num_readers; i++)
+    {
+        pthread_create(&readers[i], NULL, thread_deferred_reader, &reader_data);
+    }
+
+    for (int i = 0; i < num_nodes; i++)
+    {
+        list_delete_deferred(&head, (uint16_t)i);
+    }
+    my_assert(list_count_nodes(&head) == 0);
+
+    __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < num_readers; i++)
+    {
+        pthread_join(readers[i], NULL);
+    }
+
+    // With all readers gone the queue must drain completely
+    for (int i = 0; i < 4; i++)
+    {
+        mem_epoch_reclaim();
+    }
+    mem_stats_t stats;
+    mem_stats(&stats);
+    my_assert(stats.live_blocks == 0);
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+void test_list_sort()
+{
+    printf_yellow("  Testing list_sort and list_merge in place ---> ");
+
+    Node *head;
+    list_init(&head, 4096);
+
+    // Sorting an empty or single-node list is a no-op
+    list_sort(NULL);
+    list_sort(&head);
+    my_assert(head == NULL);
+    list_insert(&head, 42);
+    list_sort(&head);
+    my_assert(head != NULL && head->data == 42 && head->next == NULL);
+    list_cleanup(&head);
+
+    // A pseudo-random list comes out ascending with every node kept
+    unsigned int seed = 12345;
+    for (int i = 0; i < 2000; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        list_insert(&head, (uint16_t)(seed >> 16));
+    }
+    Node *first_node = list_search(&head, head->data);  // Nodes must survive in place
+    list_sort(&head);
+    int count = 0;
+    for (Node *current = head; current; current = current->next)
+    {
+        my_assert(current->next == NULL || current->data <= current->next->data);
+        count++;
+    }
+    my_assert(count == 2000);
+    my_assert(list_search(&head, first_node->data) != NULL);
+
+    // Sorting a sorted list leaves it unchanged
+    Node *before = head;
+    list_sort(&head);
+    my_assert(head == before);
+
+    // Merging two sorted lists interleaves them in order
+    Node *other = NULL;
+    for (int i = 9; i >= 0; i--)
+    {
+        list_insert(&other, (uint16_t)(i * 2 + 1));     // 1, 3, ..., 19 ascending
+    }
+    list_sort(&other);
+    head = list_merge(head, other);
+    count = 0;
+    for (Node *current = head; current; current = current->next)
+    {
+        my_assert(current->next == NULL || current->data <= current->next->data);
+        count++;
+    }
+    my_assert(count == 2010);
+
+    list_cleanup(&head);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+void test_list_serialize()
+{
+    printf_yellow("  Testing list_serialize/list_deserialize round trip ---> ");
+
+    Node *head;
+    list_init(&head, 65536);
+
+    // Build a list worth round-tripping: 10000 pseudo-random values
+    uint16_t values[10000];
+    unsigned int seed = 777;
+    for (int i = 0; i < 10000; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        values[i] = (uint16_t)(seed >> 16);
+    }
+    list_insert_bulk(&head, values, 10000);
+
+    const char *path = "/tmp/test_list_serialize.bin";
+    int fd = open(path, O_CREAT | O_TRUNC | O_RDWR, 0644);
+    my_assert(fd >= 0);
+    my_assert(list_serialize(&head, fd) == 10000);
+    list_cleanup(&head);
+
+    // Restore into a fresh list and compare element by element
+    my_assert(lseek(fd, 0, SEEK_SET) == 0);
+    my_assert(list_deserialize(&head, fd) == 10000);
+    Node *current = head;
+    for (int i = 0; i < 10000; i++)
+    {
+        my_assert(current != NULL && current->data == values[i]);
+        current = current->next;
+    }
+    my_assert(current == NULL);
+    list_cleanup(&head);
+
+    // An empty list round-trips to an empty list
+    my_assert(lseek(fd, 0, SEEK_SET) == 0);
+    my_assert(list_serialize(&head, fd) == 0);
+    my_assert(lseek(fd, 0, SEEK_SET) == 0);
+    my_assert(list_deserialize(&head, fd) == 0);
+    my_assert(head == NULL);
+
+    // A file that is not a serialized list is rejected
+    my_assert(lseek(fd, 0, SEEK_SET) == 0);
+    my_assert(write(fd, "garbage garbage!", 16) == 16);
+    my_assert(lseek(fd, 0, SEEK_SET) == 0);
+    my_assert(list_deserialize(&head, fd) == -1);
+
+    close(fd);
+    unlink(path);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+static void apply_bump_value(Node *node, void *context)
+{
+    node->data++;                                       // Touch every node exactly once
+    __atomic_fetch_add((long *)context, 1, __ATOMIC_RELAXED);
+}
+
+void test_list_parallel()
+{
+    printf_yellow("  Testing parallel count, search and apply ---> ");
+
+    Node *head;
+    list_init(&head, 131072);      // Size classes round nodes up, so leave headroom
+
+    uint16_t values[1000];
+    for (int i = 0; i < 1000; i++)
+    {
+        values[i] = (uint16_t)(i % 1000);
+    }
+    for (int batch = 0; batch < 100; batch++)
+    {
+        list_insert_bulk(&head, values, 1000);          // 100000 nodes total
+    }
+
+    // Every thread count agrees with the serial walk
+    my_assert(list_count_parallel(&head, 1) == 100000);
+    my_assert(list_count_parallel(&head, 4) == 100000);
+    my_assert(list_count_parallel(&head, 8) == 100000);
+    my_assert(list_count_parallel(&head, 0) == 100000);     // Clamped up to 1
+    my_assert(list_count_parallel(&head, 1000) == 100000);  // Clamped down
+
+    // A present key is found, an absent key is not
+    Node *hit = list_search_parallel(&head, 500, 8);
+    my_assert(hit != NULL && hit->data == 500);
+    my_assert(list_search_parallel(&head, 60000, 8) == NULL);
+
+    // Apply visits every node exactly once
+    long applied = 0;
+    list_apply_parallel(&head, apply_bump_value, &applied, 8);
+    my_assert(applied == 100000);
+    int position = 0;
+    for (Node *current = head; current; current = current->next, position++)
+    {
+        my_assert(current->data == (uint16_t)(position % 1000) + 1);
+    }
+
+    // An empty list behaves on every variant
+    Node *empty = NULL;
+    my_assert(list_count_parallel(&empty, 8) == 0);
+    my_assert(list_search_parallel(&empty, 1, 8) == NULL);
+    list_apply_parallel(&empty, apply_bump_value, &applied, 8);
+    my_assert(applied == 100000);
+
+    list_cleanup(&head);
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
 int main(int argc, char *argv[])
 {
 
@@ -670,6 +1201,17 @@ int main(int argc, char *argv[])
         printf(" 6. test_list_insert_after - Test multiple insertions after a given node\n");
         printf(" 7. test_list_insert_after - Test multiple insertions after a given node\n");
         printf(" 8. test_list_delete - Test multiple detelions\n");
+        printf(" 9. test_list_insert_bulk - Test batch insert at the end of the list\n");
+        printf(" 10. test_list_handle - Test the List handle with tail pointer and cached count\n");
+        printf(" 11. test_chunk_list - Test the cache-friendly unrolled chunk list\n");
+        printf(" 12. test_list_search_fast - Test the SIMD search against the scalar search\n");
+        printf(" 13. test_list_sorted - Test the sorted list with its skip-list index\n");
+        printf(" 14. test_clist - Test the concurrent list under racing threads\n");
+        printf(" 15. test_arena_list - Test the arena-backed list with O(1) teardown\n");
+        printf(" 16. test_list_deferred - Test deferred deletes under lock-free readers\n");
+        printf(" 17. test_list_sort - Test in-place merge sort and sorted merge\n");
+        printf(" 18. test_list_serialize - Test binary snapshot save and bulk restore\n");
+        printf(" 19. test_list_parallel - Test multi-threaded count, search and apply\n");
         printf(" 0. Run all tests\n");
         return 1;
     }
@@ -685,6 +1227,17 @@ int main(int argc, char *argv[])
         test_list_insert_after_multithread(&(TestParams){.num_threads = base_num_threads, .num_nodes = 1024});
         test_list_insert_before_multithreaded(&(TestParams){.num_threads = base_num_threads, .num_nodes = 1024});
         test_list_delete_multithreaded(&(TestParams){.num_threads = base_num_threads, .num_nodes = 1024});
+        test_list_insert_bulk();
+        test_list_handle();
+        test_chunk_list();
+        test_list_search_fast();
+        test_list_sorted();
+        test_clist();
+        test_arena_list();
+        test_list_deferred();
+        test_list_sort();
+        test_list_serialize();
+        test_list_parallel();
 
         printf("\nStress testing basic operations with various numbers of threads and nodes:\n");
         for (int i = 0; i < 9; i++)      // from 2^0 = 1 up to 2^8 = 256 threads
@@ -729,6 +1282,39 @@ int main(int argc, char *argv[])
             for (int j = 8; j < 14; j++) // from 2^8 = 256 up to 2^14 = 16384 nodes
                 test_list_delete_multithreaded(&(TestParams){.num_threads = pow(2, i), .num_nodes = pow(2, j)});
         break;
+    case 9:
+        test_list_insert_bulk();
+        break;
+    case 10:
+        test_list_handle();
+        break;
+    case 11:
+        test_chunk_list();
+        break;
+    case 12:
+        test_list_search_fast();
+        break;
+    case 13:
+        test_list_sorted();
+        break;
+    case 14:
+        test_clist();
+        break;
+    case 15:
+        test_arena_list();
+        break;
+    case 16:
+        test_list_deferred();
+        break;
+    case 17:
+        test_list_sort();
+        break;
+    case 18:
+        test_list_serialize();
+        break;
+    case 19:
+        test_list_parallel();
+        break;
 
     default:
         printf("Invalid test function\n");
@@ -432,7 +432,7 @@ void *cumulative_alloc(void *arg)
     thread_data_t *data = (thread_data_t *)arg;
 
     size_t block_size = data->block_size / 128;
-    char **blocks = (char **)malloc(128 * sizeof(char *));
+    char **blocks = (char **)calloc(128, sizeof(char *)); // Unused tail slots must free as NULL
     intptr_t returnval = 0;
     for (int i = 0; i < 128; i++)
     {
@@ -887,6 +887,403 @@ void test_looking_for_out_of_bounds(){
   printf("[PASS].\n");
 }
 
+/*
+ * Exercises mem_init_ex placement options. Huge pages and NUMA binding are
+ * best effort and may not be available on the test machine, so this only
+ * verifies that every option combination still yields a working pool.
+ */
+void test_mem_init_ex()
+{
+    mem_init_options option_sets[] = {
+        {.use_mmap = 1, .numa_node = -1},
+        {.use_mmap = 1, .use_thp = 1, .numa_node = -1},
+        {.use_huge_pages = 1, .use_thp = 1, .numa_node = -1},
+        {.use_mmap = 1, .numa_node = 0},
+    };
+    int num_sets = sizeof(option_sets) / sizeof(option_sets[0]);
+
+    for (int i = 0; i < num_sets; i++)
+    {
+        printf_yellow("  Testing mem_init_ex (mmap: %d, huge: %d, thp: %d, node: %d) ---> ",
+                      option_sets[i].use_mmap, option_sets[i].use_huge_pages,
+                      option_sets[i].use_thp, option_sets[i].numa_node);
+        mem_init_ex(1024 * 1024, &option_sets[i]);
+
+        void *blocks[32];
+        for (int j = 0; j < 32; j++)
+        {
+            blocks[j] = mem_alloc(4096);
+            my_assert(blocks[j] != NULL);
+            memset(blocks[j], 0xA5 + j, 4096);  // Touch every page so placement actually happens
+        }
+        for (int j = 0; j < 32; j++)
+        {
+            mem_free(blocks[j]);
+        }
+
+        mem_deinit();
+        printf_green("[PASS].\n");
+    }
+}
+
+
+/*
+ * Builds a pool in a memory-mapped file, writes recognizable data, tears the
+ * manager down and restores it from the same file, checking that allocations,
+ * their contents and the free space all survive the "restart".
+ */
+void test_mem_init_file()
+{
+    const char *path = "test_pool_file.bin";
+    remove(path);
+
+    printf_yellow("  Testing mem_init_file fresh pool ---> ");
+    my_assert(mem_init_file(path, 64 * 1024) == 0);
+    char *kept = (char *)mem_alloc(1024);
+    my_assert(kept != NULL);
+    for (int i = 0; i < 1024; i++)
+    {
+        kept[i] = (char)(i * 7);
+    }
+    char *dropped = (char *)mem_alloc(2048);
+    my_assert(dropped != NULL);
+    mem_free(dropped);
+    mem_deinit();   // Snapshots the pool into the file
+    printf_green("[PASS].\n");
+
+    printf_yellow("  Testing mem_init_file warm restart ---> ");
+    my_assert(mem_init_file(path, 64 * 1024) == 1);
+    for (int i = 0; i < 1024; i++)
+    {
+        my_assert(kept[i] == (char)(i * 7));    // Prior allocation is live at the same address
+    }
+    void *fresh = mem_alloc(4096);              // The freed space is usable again
+    my_assert(fresh != NULL);
+    mem_free(fresh);
+    mem_free(kept);
+    mem_deinit();
+    printf_green("[PASS].\n");
+
+    printf_yellow("  Testing mem_init_file size mismatch starts fresh ---> ");
+    my_assert(mem_init_file(path, 128 * 1024) == 0);
+    void *block = mem_alloc(100 * 1024);
+    my_assert(block != NULL);
+    mem_free(block);
+    mem_deinit();
+    printf_green("[PASS].\n");
+
+    remove(path);
+}
+
+
+/*
+ * Checks that the statistics counters track allocations, frees, request
+ * sizes and fragmentation. Exact byte counts are asserted single-threaded,
+ * where the relaxed counters are precise.
+ */
+void test_mem_stats()
+{
+    printf_yellow("  Testing mem_stats counters ---> ");
+    mem_init(64 * 1024);
+
+    mem_stats_t stats;
+    mem_stats(&stats);
+    my_assert(stats.capacity == 64 * 1024);
+    my_assert(stats.committed_bytes == 64 * 1024);
+    my_assert(stats.live_bytes == 0 && stats.live_blocks == 0);
+    my_assert(stats.largest_free_block == 64 * 1024);
+    my_assert(stats.fragmentation == 0.0);
+
+    void *blocks[10];
+    for (int i = 0; i < 10; i++)
+    {
+        blocks[i] = mem_alloc(1000);
+        my_assert(blocks[i] != NULL);
+    }
+    mem_stats(&stats);
+    my_assert(stats.alloc_count == 10);
+    my_assert(stats.live_blocks == 10);
+    my_assert(stats.live_bytes == 10 * 1000);
+    my_assert(stats.free_bytes == 64 * 1024 - 10 * 1000);
+    my_assert(stats.request_histogram[9] == 10);    // 1000 falls in the [512, 1024) bucket
+    my_assert(stats.fragmentation >= 0.0 && stats.fragmentation <= 1.0);
+
+    for (int i = 0; i < 5; i++)
+    {
+        mem_free(blocks[i]);
+    }
+    mem_stats(&stats);
+    my_assert(stats.free_count == 5);
+    my_assert(stats.live_blocks == 5);
+    my_assert(stats.live_bytes == 5 * 1000);
+
+    my_assert(mem_alloc(128 * 1024) == NULL);       // Larger than the pool
+    mem_stats(&stats);
+    my_assert(stats.failed_allocs == 1);
+
+    for (int i = 5; i < 10; i++)
+    {
+        mem_free(blocks[i]);
+    }
+    mem_stats(&stats);
+    my_assert(stats.live_bytes == 0 && stats.live_blocks == 0);
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+
+// Exercises the bump-pointer arena API: bump allocation, the O(1) reset
+// and the interaction with the surrounding pool.
+void test_mem_arena()
+{
+    printf_yellow("  Testing mem_arena create/alloc/reset/destroy ---> ");
+    mem_init(1024 * 1024);
+
+    mem_arena *arena = mem_arena_create(64 * 1024);
+    my_assert(arena != NULL);
+
+    // Bump allocations are distinct, 8-byte aligned and writable
+    char *first = mem_arena_alloc(arena, 100);
+    char *second = mem_arena_alloc(arena, 100);
+    my_assert(first != NULL && second != NULL);
+    my_assert(((size_t)first % 8) == 0 && ((size_t)second % 8) == 0);
+    my_assert(second >= first + 100);
+    memset(first, 0xAA, 100);
+    memset(second, 0xBB, 100);
+    my_assert((unsigned char)first[99] == 0xAA);
+
+    // The arena refuses requests beyond its capacity without touching the pool
+    my_assert(mem_arena_alloc(arena, 64 * 1024) == NULL);
+
+    // Reset recycles the whole arena in one step; the same memory comes back
+    mem_arena_reset(arena);
+    char *recycled = mem_arena_alloc(arena, 100);
+    my_assert(recycled == first);
+
+    // A full-capacity allocation fits right after a reset
+    mem_arena_reset(arena);
+    my_assert(mem_arena_alloc(arena, 64 * 1024) != NULL);
+
+    mem_arena_destroy(arena);
+
+    // The pool itself still serves normal allocations afterwards
+    void *block = mem_alloc(1000);
+    my_assert(block != NULL);
+    mem_free(block);
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+// Exercises epoch-based deferred reclamation: a block freed with
+// mem_free_deferred must survive while a reader section that could hold
+// it is open, and must return to the pool once the section ends.
+void test_mem_epoch()
+{
+    printf_yellow("  Testing mem_free_deferred epoch reclamation ---> ");
+    mem_init(1024 * 1024);
+
+    void *block = mem_alloc(256);
+    my_assert(block != NULL);
+
+    mem_stats_t before;
+    mem_stats(&before);
+    my_assert(before.live_blocks == 1);
+
+    // With this thread inside a section, the grace period cannot elapse
+    mem_epoch_enter();
+    mem_free_deferred(block);
+    my_assert(mem_epoch_reclaim() == 0);
+    my_assert(mem_epoch_reclaim() == 0);
+
+    mem_stats_t during;
+    mem_stats(&during);
+    my_assert(during.free_count == before.free_count);  // Still queued, not freed
+
+    // Leaving the section lets the epoch advance twice and free the block
+    mem_epoch_exit();
+    size_t reclaimed = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        reclaimed += mem_epoch_reclaim();
+    }
+    my_assert(reclaimed == 1);
+
+    mem_stats_t after;
+    mem_stats(&after);
+    my_assert(after.free_count == before.free_count + 1);
+    my_assert(after.live_blocks == 0);
+
+    mem_free_deferred(NULL);    // Must be a harmless no-op
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+void test_mem_compact()
+{
+    printf_yellow("  Testing mem_compact handle-based relocation ---> ");
+    mem_init(4096);
+
+    // Fragment the pool: allocate 16 blocks back to back, then free every
+    // other one so the holes cannot coalesce with each other
+    void *blocks[16];
+    mem_handle handles[16];
+    for (int i = 0; i < 16; i++)
+    {
+        blocks[i] = mem_alloc(200);
+        my_assert(blocks[i] != NULL);
+        memset(blocks[i], 0x40 + i, 200);
+        handles[i] = mem_handle_of(blocks[i]);
+        my_assert(handles[i] != NULL);
+        my_assert(mem_handle_ptr(handles[i]) == blocks[i]);
+    }
+    for (int i = 1; i < 16; i += 2)
+    {
+        mem_free(blocks[i]);
+    }
+
+    // 1600 bytes are free, but no single hole is large enough
+    mem_stats_t fragmented;
+    mem_stats(&fragmented);
+    my_assert(fragmented.largest_free_block < 1500);
+    my_assert(mem_alloc(1500) == NULL);
+
+    // Compaction merges the holes into one extent at the chunk tail
+    size_t largest = mem_compact();
+    my_assert(largest >= 1500);
+
+    // The survivors kept their contents; their addresses come from the
+    // handles now, since compaction moved the payloads down
+    for (int i = 0; i < 16; i += 2)
+    {
+        char *payload = mem_handle_ptr(handles[i]);
+        my_assert(payload != NULL);
+        for (int j = 0; j < 200; j++)
+        {
+            my_assert((unsigned char)payload[j] == (unsigned char)(0x40 + i));
+        }
+    }
+
+    // The allocation that failed before compaction now fits
+    void *big = mem_alloc(1500);
+    my_assert(big != NULL);
+    mem_free(big);
+
+    for (int i = 0; i < 16; i += 2)
+    {
+        mem_free(mem_handle_ptr(handles[i]));
+    }
+    mem_stats_t after;
+    mem_stats(&after);
+    my_assert(after.live_blocks == 0);
+
+    // An idle pool compacts to one free extent spanning the whole chunk
+    my_assert(mem_compact() == after.committed_bytes);
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+void test_mem_alloc_aligned()
+{
+    printf_yellow("  Testing mem_alloc_aligned placement and trimming ---> ");
+    mem_init(64 * 1024);
+
+    // Each supported alignment is honored and the block is fully usable
+    size_t alignments[] = {64, 256, 4096};
+    for (int i = 0; i < 3; i++)
+    {
+        char *block = mem_alloc_aligned(300, alignments[i]);
+        my_assert(block != NULL);
+        my_assert(((size_t)block & (alignments[i] - 1)) == 0);
+        memset(block, 0x5A + i, 300);
+        for (int j = 0; j < 300; j++)
+        {
+            my_assert((unsigned char)block[j] == (unsigned char)(0x5A + i));
+        }
+        mem_free(block);
+    }
+
+    // A non-power-of-two alignment is rejected outright
+    my_assert(mem_alloc_aligned(300, 48) == NULL);
+    my_assert(mem_alloc_aligned(300, 0) == NULL);
+
+    // Alignment 1 is a plain allocation
+    void *plain = mem_alloc_aligned(300, 1);
+    my_assert(plain != NULL);
+    mem_free(plain);
+
+    // The alignment slack is trimmed back: aligned blocks interleaved with
+    // odd-sized plain ones must not eat more pool than their own sizes
+    void *held[32];
+    for (int i = 0; i < 32; i++)
+    {
+        held[i] = (i % 2 == 0) ? mem_alloc_aligned(512, 256) : mem_alloc(100);
+        my_assert(held[i] != NULL);
+    }
+    for (int i = 0; i < 32; i++)
+    {
+        if (i % 2 == 0)
+        {
+            my_assert(((size_t)held[i] & 255) == 0);
+        }
+        mem_free(held[i]);
+    }
+
+    // Everything went back; the pool is idle again
+    mem_stats_t stats;
+    mem_stats(&stats);
+    my_assert(stats.live_blocks == 0);
+    my_assert(stats.live_bytes == 0);
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
+void test_mem_resize_in_place()
+{
+    printf_yellow("  Testing mem_resize growth in place ---> ");
+    mem_init(16384);
+
+    // Two blocks above the magazine limit sit back to back; freeing the
+    // second leaves a free neighbor right after the first
+    char *a = mem_alloc(2048);
+    my_assert(a != NULL);
+    void *b = mem_alloc(2048);
+    my_assert(b != NULL);
+    mem_free(b);
+
+    // Growing absorbs the neighbor instead of moving: same address, no copy
+    char *grown = mem_resize(a, 6000);
+    my_assert(grown == a);
+    memset(grown, 0xA1, 6000);
+    mem_stats_t stats;
+    mem_stats(&stats);
+    my_assert(stats.live_bytes == 6000);
+
+    // With a live block in the way the grow falls back to alloc-and-copy
+    void *blocker = mem_alloc(2048);
+    my_assert(blocker != NULL);
+    char *moved = mem_resize(grown, 8000);
+    my_assert(moved != NULL);
+    my_assert(moved != grown);
+    for (int i = 0; i < 6000; i++)
+    {
+        my_assert((unsigned char)moved[i] == 0xA1);
+    }
+
+    mem_free(blocker);
+    mem_free(moved);
+    mem_stats(&stats);
+    my_assert(stats.live_blocks == 0);
+    my_assert(stats.live_bytes == 0);
+
+    mem_deinit();
+    printf_green("[PASS].\n");
+}
+
 int main(int argc, char *argv[])
 {
 #ifdef VERSION
@@ -902,7 +1299,15 @@ int main(int argc, char *argv[])
         printf("  0. tests various functions with a base number of threads\n");
         printf("  1. tests various functions across variious configurations (number of threads, memory sizes,  iterations)\n");
         printf("  2. stress tests various functions with various configurations. This may take some time (especially if simulate_work flag is set to true.\n");
-	printf("  3. test_looking_for_out_of_bounds, needs LD_PRELOAD=./libmymalloc.so .\n\n");	
+	printf("  3. test_looking_for_out_of_bounds, needs LD_PRELOAD=./libmymalloc.so .\n");
+	printf("  4. test_mem_init_ex, pool placement options (mmap, huge pages, NUMA).\n");
+	printf("  5. test_mem_init_file, persistent pool snapshot and warm restart.\n");
+	printf("  6. test_mem_stats, allocator statistics counters.\n");
+	printf("  7. test_mem_arena, bump-pointer arenas carved from the pool.\n");
+	printf("  8. test_mem_epoch, deferred reclamation behind reader sections.\n");
+	printf("  9. test_mem_compact, defragmentation with handle-based relocation.\n");	
+	printf("  10. test_mem_alloc_aligned, aligned allocation with slack trimming.\n");	
+	printf("  11. test_mem_resize_in_place, resize growth by absorbing the free neighbor.\n\n");	
         return 1;
     }
 
@@ -985,6 +1390,46 @@ int main(int argc, char *argv[])
       test_looking_for_out_of_bounds();
       break;
 
+    case 4:
+        printf("\n*** Testing mem_init_ex: ***\n");
+        test_mem_init_ex();
+        break;
+
+    case 5:
+        printf("\n*** Testing mem_init_file: ***\n");
+        test_mem_init_file();
+        break;
+
+    case 6:
+        printf("\n*** Testing mem_stats: ***\n");
+        test_mem_stats();
+        break;
+
+    case 7:
+        printf("\n*** Testing mem_arena: ***\n");
+        test_mem_arena();
+        break;
+
+    case 8:
+        printf("\n*** Testing mem_free_deferred: ***\n");
+        test_mem_epoch();
+        break;
+
+    case 9:
+        printf("\n*** Testing mem_compact: ***\n");
+        test_mem_compact();
+        break;
+
+    case 10:
+        printf("\n*** Testing mem_alloc_aligned: ***\n");
+        test_mem_alloc_aligned();
+        break;
+
+    case 11:
+        printf("\n*** Testing mem_resize in place: ***\n");
+        test_mem_resize_in_place();
+        break;
+
     default:
         printf("Invalid test function\n");
         break;
@@ -0,0 +1,71 @@
+// trace_decode.c
+// Offline decoder for the binary traces recorded by the cM2.c interposer.
+// Prints one line per event in the old text-log format, prefixed with the
+// timestamp and thread id that the binary events carry.
+//
+//   usage: ./trace_decode [trace-file]     (default mtrace.bin)
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include "trace_format.h"
+
+int main(int argc, char *argv[])
+{
+    const char *path = argc > 1 ? argv[1] : "mtrace.bin";
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        fprintf(stderr, "trace_decode: cannot open %s\n", path);
+        return 1;
+    }
+
+    trace_file_header_t header;
+    if (fread(&header, sizeof(header), 1, file) != 1
+        || header.magic != TRACE_MAGIC
+        || header.version != TRACE_VERSION
+        || header.event_size != sizeof(trace_event_t))
+    {
+        fprintf(stderr, "trace_decode: %s is not a version %d trace\n", path, TRACE_VERSION);
+        fclose(file);
+        return 1;
+    }
+
+    trace_event_t event;
+    while (fread(&event, sizeof(event), 1, file) == 1)
+    {
+        printf("[%" PRIu64 " tid %u] ", event.timestamp, event.tid);
+        switch (event.op)
+        {
+        case TRACE_OP_MALLOC:
+            printf("rMALLOc (%" PRIu64 ") at 0x%" PRIx64 "\n", event.size, event.ptr);
+            break;
+        case TRACE_OP_FREE:
+            printf("rFREE at 0x%" PRIx64 "\n", event.ptr);
+            break;
+        case TRACE_OP_CALLOC:
+            printf("rCALLOC (%" PRIu64 ") at 0x%" PRIx64 "\n", event.size, event.ptr);
+            break;
+        case TRACE_OP_REALLOC_IN:
+            printf("rREALLOC-> (%" PRIu64 ") at 0x%" PRIx64 "\n", event.size, event.ptr);
+            break;
+        case TRACE_OP_REALLOC_OUT:
+            printf("rREALLOC (%" PRIu64 ") -> 0x%" PRIx64 "\n", event.size, event.ptr);
+            break;
+        case TRACE_OP_MEMALIGN:
+            printf("rMEMALING (%" PRIu64 ") @ 0x%" PRIx64 "\n", event.size, event.ptr);
+            break;
+        case TRACE_OP_MMAP:
+            printf("rMMAP (%" PRIu64 ") at 0x%" PRIx64 "\n", event.size, event.ptr);
+            break;
+        case TRACE_OP_MUNMAP:
+            printf("rMUNMMAP (0x%" PRIx64 ",%" PRIu64 ")\n", event.ptr, event.size);
+            break;
+        default:
+            printf("unknown op %u\n", event.op);
+            break;
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
@@ -0,0 +1,42 @@
+// trace_format.h
+// Shared on-disk format of the binary allocation traces written by the
+// cM2.c interposer and read by trace_decode and trace_replay.
+#ifndef TRACE_FORMAT_H
+#define TRACE_FORMAT_H
+
+#include <stdint.h>
+
+#define TRACE_MAGIC 0x43525452u     /* "RTRC" */
+#define TRACE_VERSION 1
+
+/* Event kinds; one per intercepted entry point. realloc is recorded as an
+ * in/out pair so both the released and the returned pointer are captured. */
+#define TRACE_OP_MALLOC 1
+#define TRACE_OP_FREE 2
+#define TRACE_OP_CALLOC 3
+#define TRACE_OP_REALLOC_IN 4
+#define TRACE_OP_REALLOC_OUT 5
+#define TRACE_OP_MEMALIGN 6
+#define TRACE_OP_MMAP 7
+#define TRACE_OP_MUNMAP 8
+
+/* File layout: one trace_file_header_t, then tightly packed events.
+ * Events from different threads are interleaved per flushed batch but
+ * each carries its thread id and timestamp. */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t event_size;        /* sizeof(trace_event_t) of the writer */
+    uint64_t reserved;
+} trace_file_header_t;
+
+typedef struct {
+    uint64_t timestamp;         /* rdtsc ticks (or monotonic ns off x86) */
+    uint64_t ptr;
+    uint64_t size;
+    uint32_t tid;
+    uint8_t op;
+    uint8_t pad[3];
+} trace_event_t;
+
+#endif // TRACE_FORMAT_H
@@ -0,0 +1,421 @@
+// trace_replay.c
+// Replays a binary allocation trace recorded by the cM2.c interposer
+// against the pool allocator, so allocator changes can be benchmarked on
+// real workloads instead of the synthetic loops in test_memory_manager.c.
+//
+// One replay thread is spawned per thread id found in the trace and each
+// replays its own events in recorded order, so the original thread
+// interleaving is preserved. With -p the recorded timestamps also pace
+// the replay in real time; by default it runs flat out for throughput.
+// malloc/calloc/memalign events become mem_alloc, free becomes mem_free
+// and realloc becomes a free/alloc pair; mmap and munmap events are page
+// level and are not replayed against the pool.
+//
+//   usage: ./trace_replay [-m pool_bytes] [-p ticks_per_ns] [trace-file]
+//
+// The pool defaults to twice the peak live bytes computed from the trace
+// itself, so replays of unchanged traces should not see failed allocations.
+#include "memory_manager.h"
+#include "common_defs.h"
+#include "trace_format.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_REPLAY_THREADS 64
+
+// One slot of the shared original-pointer -> replayed-pointer map. Slots
+// are claimed with a compare-and-swap on the key and never reused after
+// their free, so lookups can probe without any lock.
+typedef struct
+{
+    unsigned long long key;     // Original pointer from the trace, 0 while empty
+    void *ptr;                  // The replayed allocation
+    unsigned long long size;    // Requested size, for live-byte accounting
+} replay_slot;
+
+typedef struct
+{
+    const trace_event_t **events;   // This thread's events, in recorded order
+    long count;
+    my_barrier_t *barrier;
+    unsigned long long base_timestamp;  // Earliest timestamp in the whole trace
+    double ticks_per_ns;                // 0 disables pacing
+    long long start_ns;                 // Wall-clock start, set after the barrier
+} replay_thread_args;
+
+static replay_slot *slots;
+static unsigned long long slot_mask;
+
+static long long replayed_allocs = 0;
+static long long replayed_frees = 0;
+static long long failed_allocs = 0;
+static long long live_bytes = 0;
+static long long peak_live_bytes = 0;
+
+
+static long long now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+
+// Same finalizer the allocator uses for its pointer map
+static unsigned long long hash_key(unsigned long long key)
+{
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31;
+    return key;
+}
+
+
+// Claims an empty slot for the original pointer; the map is sized so that
+// tombstone-free probing stays short even though slots are never reused
+static void slot_put(unsigned long long key, void *ptr, unsigned long long size)
+{
+    unsigned long long index = hash_key(key) & slot_mask;
+    for (;;)
+    {
+        unsigned long long expected = 0;
+        if (__atomic_compare_exchange_n(&slots[index].key, &expected, key, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            slots[index].ptr = ptr;
+            slots[index].size = size;
+            return;
+        }
+        index = (index + 1) & slot_mask;
+    }
+}
+
+
+// Takes the replayed pointer for an original pointer, or NULL if the
+// trace frees something it never allocated (alive before tracing began)
+static void *slot_take(unsigned long long key, unsigned long long *size_out)
+{
+    unsigned long long index = hash_key(key) & slot_mask;
+    for (;;)
+    {
+        unsigned long long current = __atomic_load_n(&slots[index].key, __ATOMIC_ACQUIRE);
+        if (current == 0)
+        {
+            return NULL;
+        }
+        if (current == key && slots[index].ptr != NULL)
+        {
+            void *ptr = slots[index].ptr;
+            slots[index].ptr = NULL;    // Slot stays claimed; probing skips it
+            *size_out = slots[index].size;
+            return ptr;
+        }
+        index = (index + 1) & slot_mask;
+    }
+}
+
+
+static void account_alloc(unsigned long long size)
+{
+    __atomic_fetch_add(&replayed_allocs, 1, __ATOMIC_RELAXED);
+    long long now_live = __atomic_add_fetch(&live_bytes, (long long)size, __ATOMIC_RELAXED);
+    long long peak = __atomic_load_n(&peak_live_bytes, __ATOMIC_RELAXED);
+    while (now_live > peak
+           && !__atomic_compare_exchange_n(&peak_live_bytes, &peak, now_live, 0,
+                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+
+static void replay_alloc(unsigned long long original, unsigned long long size)
+{
+    if (original == 0)
+    {
+        return;     // The traced program's allocation failed; nothing to mirror
+    }
+    void *ptr = mem_alloc(size);
+    if (ptr == NULL)
+    {
+        __atomic_fetch_add(&failed_allocs, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    slot_put(original, ptr, size);
+    account_alloc(size);
+}
+
+
+static void replay_free(unsigned long long original)
+{
+    if (original == 0)
+    {
+        return;
+    }
+    unsigned long long size;
+    void *ptr = slot_take(original, &size);
+    if (ptr == NULL)
+    {
+        return;     // Allocated before tracing started; never entered the pool
+    }
+    mem_free(ptr);
+    __atomic_fetch_add(&replayed_frees, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&live_bytes, (long long)size, __ATOMIC_RELAXED);
+}
+
+
+static void *replay_worker(void *arg)
+{
+    replay_thread_args *args = (replay_thread_args *)arg;
+    my_barrier_wait(args->barrier);
+
+    for (long i = 0; i < args->count; i++)
+    {
+        const trace_event_t *event = args->events[i];
+
+        if (args->ticks_per_ns > 0)
+        {
+            // Hold each event back until its recorded offset has elapsed
+            long long target = args->start_ns
+                + (long long)((double)(event->timestamp - args->base_timestamp) / args->ticks_per_ns);
+            while (now_ns() < target)
+            {
+            }
+        }
+
+        switch (event->op)
+        {
+        case TRACE_OP_MALLOC:
+        case TRACE_OP_CALLOC:
+        case TRACE_OP_MEMALIGN:
+        case TRACE_OP_REALLOC_OUT:
+            replay_alloc(event->ptr, event->size);
+            break;
+        case TRACE_OP_FREE:
+        case TRACE_OP_REALLOC_IN:
+            replay_free(event->ptr);
+            break;
+        default:
+            break;      // mmap/munmap are not pool traffic
+        }
+    }
+    return NULL;
+}
+
+
+// Walks the trace once to find the peak live bytes the pool must hold
+static unsigned long long trace_peak_bytes(const trace_event_t *events, long count)
+{
+    unsigned long long peak = 0;
+    unsigned long long live = 0;
+    for (long i = 0; i < count; i++)
+    {
+        const trace_event_t *event = &events[i];
+        switch (event->op)
+        {
+        case TRACE_OP_MALLOC:
+        case TRACE_OP_CALLOC:
+        case TRACE_OP_MEMALIGN:
+        case TRACE_OP_REALLOC_OUT:
+            if (event->ptr != 0)
+            {
+                slot_put(event->ptr, (void *)1, event->size);
+                live += event->size;
+                if (live > peak)
+                {
+                    peak = live;
+                }
+            }
+            break;
+        case TRACE_OP_FREE:
+        case TRACE_OP_REALLOC_IN:
+            if (event->ptr != 0)
+            {
+                unsigned long long size;
+                if (slot_take(event->ptr, &size) != NULL)
+                {
+                    live -= size;
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return peak;
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *path = "mtrace.bin";
+    size_t pool_bytes = 0;
+    double ticks_per_ns = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            pool_bytes = (size_t)strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+        {
+            ticks_per_ns = strtod(argv[++i], NULL);
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        fprintf(stderr, "trace_replay: cannot open %s\n", path);
+        return 1;
+    }
+
+    trace_file_header_t header;
+    if (fread(&header, sizeof(header), 1, file) != 1
+        || header.magic != TRACE_MAGIC
+        || header.version != TRACE_VERSION
+        || header.event_size != sizeof(trace_event_t))
+    {
+        fprintf(stderr, "trace_replay: %s is not a version %d trace\n", path, TRACE_VERSION);
+        fclose(file);
+        return 1;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long count = (ftell(file) - (long)sizeof(header)) / (long)sizeof(trace_event_t);
+    fseek(file, sizeof(header), SEEK_SET);
+
+    trace_event_t *events = malloc((size_t)count * sizeof(trace_event_t));
+    if (events == NULL || fread(events, sizeof(trace_event_t), count, file) != (size_t)count)
+    {
+        fprintf(stderr, "trace_replay: cannot load %ld events\n", count);
+        fclose(file);
+        return 1;
+    }
+    fclose(file);
+
+    // Pointer map sized for every allocation plus slack, since slots are
+    // claimed permanently rather than tombstoned
+    unsigned long long capacity = 64;
+    while (capacity < (unsigned long long)count * 4)
+    {
+        capacity <<= 1;
+    }
+    slot_mask = capacity - 1;
+    slots = calloc(capacity, sizeof(replay_slot));
+
+    unsigned long long peak_needed = trace_peak_bytes(events, count);
+    memset(slots, 0, capacity * sizeof(replay_slot));
+    if (pool_bytes == 0)
+    {
+        pool_bytes = (size_t)(peak_needed * 2);
+        if (pool_bytes < 1024 * 1024)
+        {
+            pool_bytes = 1024 * 1024;
+        }
+    }
+
+    // Partition the events per recorded thread, preserving file order
+    unsigned int tids[MAX_REPLAY_THREADS];
+    long counts[MAX_REPLAY_THREADS] = {0};
+    int num_threads = 0;
+    unsigned long long base_timestamp = (unsigned long long)-1;
+    for (long i = 0; i < count; i++)
+    {
+        if (events[i].timestamp < base_timestamp)
+        {
+            base_timestamp = events[i].timestamp;
+        }
+        int t;
+        for (t = 0; t < num_threads; t++)
+        {
+            if (tids[t] == events[i].tid)
+            {
+                break;
+            }
+        }
+        if (t == num_threads)
+        {
+            if (num_threads == MAX_REPLAY_THREADS)
+            {
+                fprintf(stderr, "trace_replay: more than %d thread ids in trace\n", MAX_REPLAY_THREADS);
+                return 1;
+            }
+            tids[num_threads++] = events[i].tid;
+        }
+        counts[t]++;
+    }
+
+    replay_thread_args args[MAX_REPLAY_THREADS];
+    for (int t = 0; t < num_threads; t++)
+    {
+        args[t].events = malloc(counts[t] * sizeof(trace_event_t *));
+        args[t].count = 0;
+    }
+    for (long i = 0; i < count; i++)
+    {
+        for (int t = 0; t < num_threads; t++)
+        {
+            if (tids[t] == events[i].tid)
+            {
+                args[t].events[args[t].count++] = &events[i];
+                break;
+            }
+        }
+    }
+
+    mem_init(pool_bytes);
+
+    pthread_t threads[MAX_REPLAY_THREADS];
+    my_barrier_t barrier;
+    my_barrier_init(&barrier, num_threads + 1);     // +1 so main releases all replayers at once
+
+    for (int t = 0; t < num_threads; t++)
+    {
+        args[t].barrier = &barrier;
+        args[t].base_timestamp = base_timestamp;
+        args[t].ticks_per_ns = ticks_per_ns;
+        args[t].start_ns = 0;
+        pthread_create(&threads[t], NULL, replay_worker, &args[t]);
+    }
+
+    long long start = now_ns();
+    for (int t = 0; t < num_threads; t++)
+    {
+        args[t].start_ns = start;
+    }
+    my_barrier_wait(&barrier);
+    for (int t = 0; t < num_threads; t++)
+    {
+        pthread_join(threads[t], NULL);
+    }
+    long long wall_ns = now_ns() - start;
+
+    double seconds = (double)wall_ns / 1e9;
+    printf("trace:            %s\n", path);
+    printf("events:           %ld across %d threads\n", count, num_threads);
+    printf("pool:             %zu bytes (trace peak %llu)\n", pool_bytes, peak_needed);
+    printf("replayed:         %lld allocs, %lld frees, %lld failed\n",
+           replayed_allocs, replayed_frees, failed_allocs);
+    printf("peak live bytes:  %lld\n", peak_live_bytes);
+    printf("elapsed:          %.6f s (%.0f ops/s)\n", seconds,
+           (double)(replayed_allocs + replayed_frees) / seconds);
+
+    mem_deinit();
+    for (int t = 0; t < num_threads; t++)
+    {
+        free((void *)args[t].events);
+    }
+    free(slots);
+    free(events);
+    my_barrier_destroy(&barrier);
+    return 0;
+}